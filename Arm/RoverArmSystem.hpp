@@ -1,5 +1,6 @@
 #pragma once
 #include "utility/math/units.hpp"
+#include "arm_client.hpp"
 #include "joint.hpp"
 #include "wrist_joint.hpp"
 
@@ -51,13 +52,38 @@ class RoverArmSystem
     Wrist.Initialize();
   }
 
-  /// Retrives all of information for arm movement from the Mission Control
-  /// server. Returns True if successful.
-  bool GetData()
+  /// Takes the latest commands for arm movement from mission control, as
+  /// posted by ArmClient. Returns True if new commands arrived.
+  bool GetData(ArmCommandMailbox & commands)
   {
+    MissionControlData data;
+    if (!commands.Read(data))
+    {
+      return false;
+    }
+    isOperational   = data.is_operational;
+    rotunda_pos     = units::angle::degree_t(data.rotunda);
+    shoulder_pos    = units::angle::degree_t(data.shoulder);
+    elbow_pos       = units::angle::degree_t(data.elbow);
+    wrist_pitch_pos = units::angle::degree_t(data.wrist_pitch);
+    wrist_roll_pos  = units::angle::degree_t(data.wrist_roll);
     return true;
   }
 
+  /// Reports the target angles the arm is holding to mission control,
+  /// through ArmClient.
+  void PostTelemetry(ArmTelemetryMailbox & telemetry)
+  {
+    MissionControlData data;
+    data.is_operational = isOperational;
+    data.rotunda        = rotunda_pos.to<float>();
+    data.shoulder       = shoulder_pos.to<float>();
+    data.elbow          = elbow_pos.to<float>();
+    data.wrist_pitch    = wrist_pitch_pos.to<float>();
+    data.wrist_roll     = wrist_roll_pos.to<float>();
+    telemetry.Write(data);
+  }
+
   /// Moves each of the arm joints to the aproppriate angle
   /// Returns True if successful.
   bool MoveArm()
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string_view>
+
+#include "../Common/mailbox.hpp"
+#include "../Common/mission_control_exchange.hpp"
+#include "mission_control_data.hpp"
+
+namespace sjsu::arm
+{
+using ArmCommandMailbox   = common::Mailbox<MissionControlData>;
+using ArmTelemetryMailbox = common::Mailbox<MissionControlData>;
+
+/// Arm side of the mission control exchange: reports the joint angles the
+/// arm is holding and posts the commands that come back to the arm
+class ArmClient final : public common::MissionControlClient
+{
+ public:
+  static constexpr std::string_view kName = "arm";
+  static constexpr std::string_view kEndpoint =
+      "Vishnu-Adda/json-robo-test/arm";
+
+  ArmClient(ArmCommandMailbox & commands, ArmTelemetryMailbox & telemetry)
+      : commands_(commands), telemetry_(telemetry)
+  {
+  }
+
+  std::string_view GetName() const override
+  {
+    return kName;
+  }
+
+  std::string_view GetEndpoint() const override
+  {
+    return kEndpoint;
+  }
+
+  void WriteTelemetry(common::RequestWriter & request) override
+  {
+    telemetry_.Read(latest_telemetry_);
+    request.AppendParameter("is_operational",
+                            latest_telemetry_.is_operational);
+    auto angles = GetJointAngles(latest_telemetry_);
+    for (size_t i = 0; i < angles.size(); i++)
+    {
+      request.AppendParameter(kJointParameters[i], *angles[i]);
+    }
+  }
+
+  common::Status ReceiveCommands(std::string_view json) override
+  {
+    // Missing fields keep the value of the previous command
+    if (ParseMissionControlData(json, command_) == 0)
+    {
+      return common::Status::kBadResponse;
+    }
+    commands_.Write(command_);
+    return common::Status::kOk;
+  }
+
+ private:
+  ArmCommandMailbox & commands_;
+  ArmTelemetryMailbox & telemetry_;
+  MissionControlData latest_telemetry_;
+  MissionControlData command_;
+};
+}  // namespace sjsu::arm
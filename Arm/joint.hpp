@@ -58,7 +58,9 @@ class Joint
     units::angle::degree_t calibrated_angle = angle - zero_offset_angle;
     calibrated_angle                        = units::math::min(
         units::math::max(calibrated_angle, minimum_angle), maximum_angle);
-    sjsu::LogInfo("%f", calibrated_angle.to<double>());
+    // Whole degrees keep the log free of double precision math
+    sjsu::LogDebug("Moving joint to %d degrees",
+                   static_cast<int>(calibrated_angle.to<float>()));
     motor.SetAngle(calibrated_angle);
   }
 
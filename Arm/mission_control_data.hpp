@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "../Common/json_reader.hpp"
+
+namespace sjsu::arm
+{
+/// Arm commands received from mission control. The arm reports the angles
+/// it is holding with the same fields.
+struct MissionControlData
+{
+  int is_operational = 0;
+  /// Target angle of each joint in degrees
+  float rotunda     = 0.0f;
+  float shoulder    = 0.0f;
+  float elbow       = 0.0f;
+  float wrist_pitch = 0.0f;
+  float wrist_roll  = 0.0f;
+};
+
+/// Names of the joint angle fields, in the order of GetJointAngles()
+inline constexpr std::array<std::string_view, 5> kJointParameters = {
+  "rotunda", "shoulder", "elbow", "wrist_pitch", "wrist_roll",
+};
+
+/// @return pointers to the joint angles, in the order of kJointParameters
+template <typename Data>
+auto GetJointAngles(Data & data)
+{
+  return std::array{
+    &data.rotunda,     &data.shoulder,   &data.elbow,
+    &data.wrist_pitch, &data.wrist_roll,
+  };
+}
+
+/// Reads is_operational and the joint angles from a mission control JSON
+/// response in a single pass, in any order. Unknown keys are ignored and
+/// only the fields that are present and valid are written to data.
+/// @param json response body i.e. {"is_operational": 1, "rotunda": 30...}
+/// @param data commands to update
+/// @return number of fields that were updated
+inline uint8_t ParseMissionControlData(std::string_view json,
+                                       MissionControlData & data)
+{
+  uint8_t fields = 0;
+  auto angles    = GetJointAngles(data);
+  common::JsonReader reader(json);
+  while (reader.Next())
+  {
+    std::string_view key            = reader.GetKey();
+    const common::JsonValue & value = reader.GetValue();
+
+    if (key == "is_operational")
+    {
+      bool is_operational;
+      if (value.ToBoolean(is_operational))
+      {
+        data.is_operational = is_operational;
+        fields++;
+      }
+      continue;
+    }
+    for (size_t i = 0; i < angles.size(); i++)
+    {
+      if (key == kJointParameters[i] && value.ToFloat(*angles[i]))
+      {
+        fields++;
+      }
+    }
+  }
+  return fields;
+}
+}  // namespace sjsu::arm
@@ -1,5 +1,7 @@
 #include "utility/log.hpp"
 #include "RoverArmSystem.hpp"
+#include "../../Common/mission_control_exchange.hpp"
+#include "../../Common/periodic_executive.hpp"
 #include "peripherals/lpc40xx/i2c.hpp"
 #include "peripherals/lpc40xx/can.hpp"
 #include "devices/actuators/servo/rmd_x.hpp"
@@ -44,10 +46,25 @@ int main()
   // armControl.Initialize();
   // armControl.Home();
 
-  // while (true)
-  // {
-  //   armControl.GetData();
+  // // Exchange telemetry for commands with mission control. A board that
+  // // also runs the drive adds its DriveClient to the same exchange, so both
+  // // share one round-trip to the batched endpoint.
+  // sjsu::common::Esp esp;
+  // sjsu::arm::ArmCommandMailbox commands;
+  // sjsu::arm::ArmTelemetryMailbox telemetry;
+  // sjsu::arm::ArmClient arm_client(commands, telemetry);
+  // sjsu::common::MissionControlExchange exchange(esp);
+  // exchange.AddClient(arm_client);
+  // exchange.Initialize();
+
+  // // Run the arm at fixed 100ms deadlines so the period does not drift with
+  // // how long each step takes.
+  // sjsu::common::PeriodicExecutive<3> executive(100ms);
+  // executive.AddStep("exchange", [&]() { exchange.Exchange(); });
+  // executive.AddStep("get data", [&]() { armControl.GetData(commands); });
+  // executive.AddStep("move arm", [&]() {
   //   armControl.MoveArm();
-  //   sjsu::Delay(100ms);
-  // }
+  //   armControl.PostTelemetry(telemetry);
+  // });
+  // executive.Run();
 }
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace sjsu::common
+{
+/// ByteRing is a lock-free single producer, single consumer byte queue. The
+/// producer is meant to be an interrupt handler or DMA completion callback
+/// and the consumer a task, so neither side ever blocks or disables
+/// interrupts: each only writes its own index.
+///
+/// Bytes pushed while the ring is full are dropped and counted, the bytes
+/// already queued are never overwritten.
+///
+/// Only one context may Push() and only one context may Pop().
+template <size_t kCapacity>
+class ByteRing
+{
+ public:
+  static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+  /// Queues as many bytes as fit. Producer only.
+  /// @return number of bytes queued, the rest were dropped
+  size_t Push(std::span<const uint8_t> bytes)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+    size_t count  = std::min(bytes.size(), kCapacity - (head - tail));
+
+    size_t start = head & kIndexMask;
+    size_t first = std::min(count, kCapacity - start);
+    std::memcpy(&buffer_[start], bytes.data(), first);
+    std::memcpy(&buffer_[0], bytes.data() + first, count - first);
+    head_.store(head + static_cast<uint32_t>(count), std::memory_order_release);
+
+    size_t size = (head - tail) + count;
+    if (size > peak_size_.load(std::memory_order_relaxed))
+    {
+      peak_size_.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    }
+    if (count < bytes.size())
+    {
+      dropped_.fetch_add(static_cast<uint32_t>(bytes.size() - count),
+                         std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  /// Takes up to bytes.size() of the oldest bytes. Consumer only.
+  /// @return number of bytes copied into bytes
+  size_t Pop(std::span<uint8_t> bytes)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    uint32_t head = head_.load(std::memory_order_acquire);
+    size_t count  = std::min(bytes.size(), static_cast<size_t>(head - tail));
+
+    size_t start = tail & kIndexMask;
+    size_t first = std::min(count, kCapacity - start);
+    std::memcpy(bytes.data(), &buffer_[start], first);
+    std::memcpy(bytes.data() + first, &buffer_[0], count - first);
+    tail_.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+    return count;
+  }
+
+  /// @return number of bytes queued
+  size_t Size() const
+  {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  bool IsEmpty() const
+  {
+    return Size() == 0;
+  }
+
+  /// @return most bytes ever queued at once, to size the ring
+  size_t GetPeakSize() const
+  {
+    return peak_size_.load(std::memory_order_relaxed);
+  }
+
+  /// @return number of bytes dropped because the ring was full
+  uint32_t GetDroppedCount() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t kIndexMask = kCapacity - 1;
+
+  std::array<uint8_t, kCapacity> buffer_;
+  // Free running, wrap at 2^32 which kCapacity divides
+  std::atomic<uint32_t> head_      = 0;
+  std::atomic<uint32_t> tail_      = 0;
+  std::atomic<uint32_t> peak_size_ = 0;
+  std::atomic<uint32_t> dropped_   = 0;
+};
+}  // namespace sjsu::common
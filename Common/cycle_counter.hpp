@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace sjsu::common
+{
+/// CycleCounter reads the Cortex-M4 DWT cycle counter, which counts every CPU
+/// clock cycle at no cost to the code being measured. Wraps every ~36s at
+/// 120MHz, differences of uint32_t still work across one wrap.
+///
+/// Host builds count nanoseconds of the steady clock instead, so the same
+/// code can be measured in unit tests and benchmarks.
+class CycleCounter
+{
+ public:
+  /// Starts the counter, call once before Now()
+  static void Enable()
+  {
+#if defined(__ARM_ARCH)
+    // Trace must be enabled (DEMCR.TRCENA) for the DWT to run
+    *kDemcr |= kDemcrTraceEnable;
+    *kDwtCycleCount = 0;
+    *kDwtControl |= kDwtCycleCountEnable;
+#endif
+  }
+
+  /// @return cycles since Enable(), nanoseconds on the host
+  static uint32_t Now()
+  {
+#if defined(__ARM_ARCH)
+    return *kDwtCycleCount;
+#else
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+  }
+
+ private:
+#if defined(__ARM_ARCH)
+  static inline volatile uint32_t * const kDemcr =
+      reinterpret_cast<volatile uint32_t *>(0xE000'EDFC);
+  static inline volatile uint32_t * const kDwtControl =
+      reinterpret_cast<volatile uint32_t *>(0xE000'1000);
+  static inline volatile uint32_t * const kDwtCycleCount =
+      reinterpret_cast<volatile uint32_t *>(0xE000'1004);
+  static constexpr uint32_t kDemcrTraceEnable    = 1 << 24;
+  static constexpr uint32_t kDwtCycleCountEnable = 1 << 0;
+#endif
+};
+
+/// Min, max and mean of a number of cycles, i.e. of one control tick
+class CycleStatistics
+{
+ public:
+  /// Adds one sample
+  /// @param cycles CycleCounter::Now() difference
+  void Record(uint32_t cycles)
+  {
+    if (count_ == 0 || cycles < min_)
+    {
+      min_ = cycles;
+    }
+    max_ = std::max(max_, cycles);
+    sum_ += cycles;
+    count_++;
+  }
+
+  /// Forgets all samples
+  void Reset()
+  {
+    *this = CycleStatistics();
+  }
+
+  uint32_t GetCount() const
+  {
+    return count_;
+  }
+
+  uint32_t GetMin() const
+  {
+    return min_;
+  }
+
+  uint32_t GetMax() const
+  {
+    return max_;
+  }
+
+  uint32_t GetMean() const
+  {
+    return (count_ == 0) ? 0 : static_cast<uint32_t>(sum_ / count_);
+  }
+
+ private:
+  uint32_t count_ = 0;
+  uint32_t min_   = 0;
+  uint32_t max_   = 0;
+  uint64_t sum_   = 0;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,565 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "utility/log.hpp"
+#include "utility/time/time.hpp"
+
+/// Deferred log calls below this level are compiled out:
+/// 0 = debug, 1 = info, 2 = warning, 3 = error. Set with -D DEFERRED_LOG_LEVEL
+#if !defined(DEFERRED_LOG_LEVEL)
+#define DEFERRED_LOG_LEVEL 1
+#endif
+
+namespace sjsu::common
+{
+enum class LogLevel : uint8_t
+{
+  kDebug   = 0,
+  kInfo    = 1,
+  kWarning = 2,
+  kError   = 3,
+};
+
+inline constexpr LogLevel kDeferredLogLevel =
+    static_cast<LogLevel>(DEFERRED_LOG_LEVEL);
+
+/// DeferredLog takes printf formatting off the control loop. Recording a
+/// message only copies the format string pointer, a timestamp and the raw
+/// arguments into a RAM ring buffer, which takes a few dozen cycles instead
+/// of blocking on the UART. A low priority task formats and prints the
+/// messages later with Drain().
+///
+/// The format string must be a string literal: its address in flash is the
+/// message id. %s arguments are stored as pointers too, so they must point
+/// to strings that are never modified or freed. Supports up to kMaxWords
+/// 32-bit words of arguments (64-bit integers, doubles and host pointers take
+/// two), checked at compile time. '*' widths are not supported.
+///
+/// Any number of tasks may record messages, only one task may Drain() or
+/// Pop(). Messages recorded while the buffer is full are dropped and counted.
+template <size_t kCapacity>
+class DeferredLog
+{
+ public:
+  static_assert(kCapacity != 0 && (kCapacity & (kCapacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+  using UptimeFunction = std::chrono::nanoseconds (*)();
+  /// 32-bit words of arguments a message can hold
+  static constexpr size_t kMaxWords = 6;
+
+  /// How an argument was stored
+  enum class ArgumentKind : uint8_t
+  {
+    kSigned,
+    kUnsigned,
+    kSigned64,
+    kUnsigned64,
+    kFloat,
+    kDouble,
+    kString,
+    kPointer,
+  };
+
+  /// One recorded message
+  struct Entry
+  {
+    const char * format    = "";
+    uint32_t timestamp     = 0;  // microseconds since boot, wraps every ~71min
+    LogLevel level         = LogLevel::kInfo;
+    uint8_t argument_count = 0;
+    std::array<ArgumentKind, kMaxWords> kinds;
+    std::array<uint32_t, kMaxWords> words;
+  };
+
+  explicit DeferredLog(UptimeFunction uptime = sjsu::Uptime) : uptime_(uptime)
+  {
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+      slots_[i].sequence.store(static_cast<uint32_t>(i),
+                               std::memory_order_relaxed);
+    }
+  }
+
+  /// Records a message without formatting it. Never blocks.
+  /// @return false if the buffer was full and the message was dropped
+  template <typename... Arguments>
+  bool Record(LogLevel level, const char * format, Arguments... arguments)
+  {
+    static_assert((WordsOf(KindOf<Arguments>()) + ... + 0) <= kMaxWords,
+                  "Too many arguments for a deferred log message");
+
+    uint32_t position = head_.load(std::memory_order_relaxed);
+    Slot * slot;
+    while (true)
+    {
+      slot              = &slots_[position & kIndexMask];
+      uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+      auto difference   = static_cast<int32_t>(sequence - position);
+      if (difference == 0)
+      {
+        // Claim the slot, another task may have claimed it first
+        if (head_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (difference < 0)
+      {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      else
+      {
+        position = head_.load(std::memory_order_relaxed);
+      }
+    }
+
+    Entry & entry = slot->entry;
+    entry.format  = format;
+    entry.timestamp = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(uptime_())
+            .count());
+    entry.level          = level;
+    entry.argument_count = sizeof...(Arguments);
+
+    [[maybe_unused]] size_t word  = 0;
+    [[maybe_unused]] size_t index = 0;
+    (Store(entry, index, word, arguments), ...);
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Takes the oldest message out of the buffer
+  /// @return false if the buffer is empty
+  bool Pop(Entry & entry)
+  {
+    Slot & slot       = slots_[tail_ & kIndexMask];
+    uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != tail_ + 1)
+    {
+      return false;
+    }
+    entry = slot.entry;
+    slot.sequence.store(tail_ + kCapacity, std::memory_order_release);
+    tail_++;
+    return true;
+  }
+
+  /// Formats and prints up to max_entries messages with the sjsu::Log
+  /// function of their level, prefixed with the time they were recorded.
+  /// @return number of messages printed
+  size_t Drain(size_t max_entries = kCapacity)
+  {
+    uint32_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_)
+    {
+      sjsu::LogWarning("%lu log messages dropped!",
+                       static_cast<unsigned long>(dropped - reported_dropped_));
+      reported_dropped_ = dropped;
+    }
+
+    size_t printed = 0;
+    Entry entry;
+    while (printed < max_entries && Pop(entry))
+    {
+      std::array<char, 160> line;
+      Format(entry, line);
+      unsigned long seconds      = entry.timestamp / 1'000'000;
+      unsigned long microseconds = entry.timestamp % 1'000'000;
+      switch (entry.level)
+      {
+        case LogLevel::kDebug:
+          sjsu::LogDebug("[%lu.%06lu] %s", seconds, microseconds, line.data());
+          break;
+        case LogLevel::kInfo:
+          sjsu::LogInfo("[%lu.%06lu] %s", seconds, microseconds, line.data());
+          break;
+        case LogLevel::kWarning:
+          sjsu::LogWarning("[%lu.%06lu] %s", seconds, microseconds,
+                           line.data());
+          break;
+        case LogLevel::kError:
+          sjsu::LogError("[%lu.%06lu] %s", seconds, microseconds, line.data());
+          break;
+      }
+      printed++;
+    }
+    return printed;
+  }
+
+  /// Formats a recorded message like printf would have
+  /// @param output always null terminated, long messages are truncated
+  /// @return length of the formatted message
+  static size_t Format(const Entry & entry, std::span<char> output)
+  {
+    if (output.empty())
+    {
+      return 0;
+    }
+    size_t length = 0;
+    size_t index  = 0;
+    size_t word   = 0;
+    auto append   = [&](const char * text, size_t size) {
+      size_t count = std::min(size, output.size() - 1 - length);
+      std::memcpy(output.data() + length, text, count);
+      length += count;
+    };
+
+    const char * format = entry.format;
+    while (*format != '\0')
+    {
+      if (*format != '%')
+      {
+        append(format++, 1);
+        continue;
+      }
+      if (format[1] == '%')
+      {
+        append("%", 1);
+        format += 2;
+        continue;
+      }
+
+      // Rebuild the conversion with the length the stored value needs
+      std::array<char, 16> specification;
+      size_t size           = 0;
+      const char * start    = format;
+      specification[size++] = *format++;
+      while (std::strchr("-+ #0123456789.", *format) != nullptr &&
+             *format != '\0' && size < specification.size() - 4)
+      {
+        specification[size++] = *format++;
+      }
+      while (*format != '\0' && std::strchr("hljztL", *format) != nullptr)
+      {
+        format++;
+      }
+      char conversion = *format;
+      if (conversion == '\0' || index >= entry.argument_count)
+      {
+        // Malformed or missing argument, print it as written
+        append(start, static_cast<size_t>(format - start));
+        continue;
+      }
+      format++;
+
+      ArgumentKind kind = entry.kinds[index++];
+      Value value       = Load(entry, word, kind);
+      std::array<char, 48> text;
+      int written = 0;
+      if (std::strchr("di", conversion) != nullptr)
+      {
+        Finish(specification, size, "ll", conversion);
+        written = snprintf(text.data(), text.size(), specification.data(),
+                           value.AsSigned());
+      }
+      else if (std::strchr("ouxX", conversion) != nullptr)
+      {
+        Finish(specification, size, "ll", conversion);
+        written = snprintf(text.data(), text.size(), specification.data(),
+                           value.AsUnsigned());
+      }
+      else if (conversion == 'c')
+      {
+        Finish(specification, size, "", conversion);
+        written = snprintf(text.data(), text.size(), specification.data(),
+                           static_cast<int>(value.AsSigned()));
+      }
+      else if (std::strchr("fFeEgGaA", conversion) != nullptr)
+      {
+        Finish(specification, size, "", conversion);
+        written = snprintf(text.data(), text.size(), specification.data(),
+                           value.AsDouble());
+      }
+      else if (conversion == 's')
+      {
+        Finish(specification, size, "", conversion);
+        const char * string = "(?)";
+        if (kind == ArgumentKind::kString)
+        {
+          string = reinterpret_cast<const char *>(value.pointer);
+        }
+        written = snprintf(text.data(), text.size(), specification.data(),
+                           (string == nullptr) ? "(null)" : string);
+      }
+      else if (conversion == 'p')
+      {
+        Finish(specification, size, "", conversion);
+        written = snprintf(text.data(), text.size(), specification.data(),
+                           reinterpret_cast<void *>(value.pointer));
+      }
+      else
+      {
+        append(start, static_cast<size_t>(format - start));
+        continue;
+      }
+      if (written > 0)
+      {
+        append(text.data(),
+               std::min(static_cast<size_t>(written), text.size() - 1));
+      }
+    }
+    output[length] = '\0';
+    return length;
+  }
+
+  /// @return messages dropped because the buffer was full
+  uint32_t GetDroppedCount() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t kIndexMask = kCapacity - 1;
+  static constexpr size_t kPointerWords =
+      (sizeof(uintptr_t) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  struct Slot
+  {
+    /// Equals the write position while free and position + 1 once written
+    std::atomic<uint32_t> sequence = 0;
+    Entry entry;
+  };
+
+  /// A stored argument widened back to its largest type
+  struct Value
+  {
+    ArgumentKind kind;
+    int64_t integer   = 0;
+    double real       = 0.0;
+    uintptr_t pointer = 0;
+
+    long long AsSigned() const
+    {
+      return IsReal() ? static_cast<long long>(real)
+                      : static_cast<long long>(integer);
+    }
+
+    unsigned long long AsUnsigned() const
+    {
+      return IsReal() ? static_cast<unsigned long long>(real)
+                      : static_cast<unsigned long long>(integer);
+    }
+
+    double AsDouble() const
+    {
+      return IsReal() ? real : static_cast<double>(integer);
+    }
+
+    bool IsReal() const
+    {
+      return kind == ArgumentKind::kFloat || kind == ArgumentKind::kDouble;
+    }
+  };
+
+  template <typename T>
+  static constexpr ArgumentKind KindOf()
+  {
+    using Type = std::decay_t<T>;
+    if constexpr (std::is_enum_v<Type>)
+    {
+      return KindOf<std::underlying_type_t<Type>>();
+    }
+    else if constexpr (std::is_same_v<Type, float>)
+    {
+      return ArgumentKind::kFloat;
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+      return ArgumentKind::kDouble;
+    }
+    else if constexpr (std::is_same_v<Type, const char *> ||
+                       std::is_same_v<Type, char *>)
+    {
+      return ArgumentKind::kString;
+    }
+    else if constexpr (std::is_pointer_v<Type>)
+    {
+      return ArgumentKind::kPointer;
+    }
+    else
+    {
+      static_assert(std::is_integral_v<Type>,
+                    "Deferred log arguments must be numbers or pointers");
+      if constexpr (sizeof(Type) > sizeof(uint32_t))
+      {
+        return std::is_signed_v<Type> ? ArgumentKind::kSigned64
+                                      : ArgumentKind::kUnsigned64;
+      }
+      else
+      {
+        return std::is_signed_v<Type> ? ArgumentKind::kSigned
+                                      : ArgumentKind::kUnsigned;
+      }
+    }
+  }
+
+  static constexpr size_t WordsOf(ArgumentKind kind)
+  {
+    switch (kind)
+    {
+      case ArgumentKind::kSigned64:
+      case ArgumentKind::kUnsigned64:
+      case ArgumentKind::kDouble: return 2;
+      case ArgumentKind::kString:
+      case ArgumentKind::kPointer: return kPointerWords;
+      default: return 1;
+    }
+  }
+
+  template <typename T>
+  static void Store(Entry & entry, size_t & index, size_t & word, T argument)
+  {
+    constexpr ArgumentKind kKind = KindOf<T>();
+    entry.kinds[index++]         = kKind;
+
+    uint64_t bits = 0;
+    if constexpr (kKind == ArgumentKind::kFloat)
+    {
+      uint32_t float_bits;
+      std::memcpy(&float_bits, &argument, sizeof(float_bits));
+      bits = float_bits;
+    }
+    else if constexpr (kKind == ArgumentKind::kDouble)
+    {
+      double real = static_cast<double>(argument);
+      std::memcpy(&bits, &real, sizeof(bits));
+    }
+    else if constexpr (kKind == ArgumentKind::kString ||
+                       kKind == ArgumentKind::kPointer)
+    {
+      bits = reinterpret_cast<uintptr_t>(argument);
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+      bits = static_cast<uint64_t>(
+          static_cast<std::underlying_type_t<T>>(argument));
+    }
+    else
+    {
+      bits = static_cast<uint64_t>(argument);
+    }
+
+    for (size_t i = 0; i < WordsOf(kKind); i++)
+    {
+      entry.words[word++] = static_cast<uint32_t>(bits >> (32 * i));
+    }
+  }
+
+  static Value Load(const Entry & entry, size_t & word, ArgumentKind kind)
+  {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < WordsOf(kind); i++)
+    {
+      bits |= static_cast<uint64_t>(entry.words[word++]) << (32 * i);
+    }
+
+    Value value;
+    value.kind = kind;
+    switch (kind)
+    {
+      case ArgumentKind::kSigned:
+        value.integer = static_cast<int32_t>(bits);
+        break;
+      case ArgumentKind::kUnsigned:
+        value.integer = static_cast<uint32_t>(bits);
+        break;
+      case ArgumentKind::kSigned64:
+      case ArgumentKind::kUnsigned64:
+        value.integer = static_cast<int64_t>(bits);
+        break;
+      case ArgumentKind::kFloat:
+      {
+        float real;
+        auto float_bits = static_cast<uint32_t>(bits);
+        std::memcpy(&real, &float_bits, sizeof(real));
+        value.real = real;
+        break;
+      }
+      case ArgumentKind::kDouble:
+        std::memcpy(&value.real, &bits, sizeof(value.real));
+        break;
+      case ArgumentKind::kString:
+      case ArgumentKind::kPointer:
+        value.pointer = static_cast<uintptr_t>(bits);
+        break;
+    }
+    return value;
+  }
+
+  /// Appends the length modifier, conversion and null terminator
+  static void Finish(std::array<char, 16> & specification,
+                     size_t size,
+                     const char * length,
+                     char conversion)
+  {
+    while (*length != '\0')
+    {
+      specification[size++] = *length++;
+    }
+    specification[size++] = conversion;
+    specification[size]   = '\0';
+  }
+
+  UptimeFunction uptime_;
+  std::array<Slot, kCapacity> slots_;
+  /// Next position to claim, shared by every recording task
+  std::atomic<uint32_t> head_ = 0;
+  /// Next position to read, owned by the draining task
+  uint32_t tail_ = 0;
+  std::atomic<uint32_t> dropped_ = 0;
+  uint32_t reported_dropped_     = 0;
+};
+
+/// Deferred log shared by the whole firmware, ~3kB of RAM
+inline DeferredLog<64> deferred_log;
+
+template <typename... Arguments>
+void DeferLogDebug(const char * format, Arguments... arguments)
+{
+  if constexpr (kDeferredLogLevel <= LogLevel::kDebug)
+  {
+    deferred_log.Record(LogLevel::kDebug, format, arguments...);
+  }
+}
+
+template <typename... Arguments>
+void DeferLogInfo(const char * format, Arguments... arguments)
+{
+  if constexpr (kDeferredLogLevel <= LogLevel::kInfo)
+  {
+    deferred_log.Record(LogLevel::kInfo, format, arguments...);
+  }
+}
+
+template <typename... Arguments>
+void DeferLogWarning(const char * format, Arguments... arguments)
+{
+  if constexpr (kDeferredLogLevel <= LogLevel::kWarning)
+  {
+    deferred_log.Record(LogLevel::kWarning, format, arguments...);
+  }
+}
+
+template <typename... Arguments>
+void DeferLogError(const char * format, Arguments... arguments)
+{
+  if constexpr (kDeferredLogLevel <= LogLevel::kError)
+  {
+    deferred_log.Record(LogLevel::kError, format, arguments...);
+  }
+}
+}  // namespace sjsu::common
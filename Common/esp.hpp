@@ -2,10 +2,17 @@
 
 #include <string_view>
 #include <algorithm>
+#include <optional>
 
 #include "utility/log.hpp"
 #include "peripherals/lpc40xx/uart.hpp"
 #include "devices/communication/esp8266.hpp"
+#include "utility/timeout_timer.hpp"
+#include "http_response_parser.hpp"
+#include "request_writer.hpp"
+#include "status.hpp"
+#include "task_delay.hpp"
+#include "wifi_link.hpp"
 
 namespace sjsu::common
 {
@@ -13,103 +20,379 @@ namespace sjsu::common
 class Esp
 {
  public:
-  Esp()
-      : esp_(sjsu::lpc40xx::GetUart<3>()),
-        wifi_(esp_.GetWiFi()),
-        socket_(esp_.GetInternetSocket()){};
+  /// Size of the buffer the full HTTP request (line + headers) is built in
+  static constexpr size_t kRequestCapacity = 512;
+  /// Number of bytes requested from the socket per read
+  static constexpr size_t kReadChunkSize = 256;
+  /// Size of the ring responses are received into on the rover, holds over
+  /// 10ms of data even at 921600 baud while the network task is preempted
+  static constexpr size_t kReceiveRingCapacity = 1024;
 
-  /// Initializes the Wi-Fi module by connecting to WiFi
+  /// Mission control server the rover talks to by default
+  static constexpr std::string_view kDefaultUrl = "my-json-server.typicode.com";
+  static constexpr uint16_t kDefaultPort        = 80;
+
+  /// Talks to mission control through the esp01 on UART3
+  Esp() : Esp(sjsu::lpc40xx::GetUart<3>()) {}
+
+  /// Talks to mission control through an esp01
+  /// @param uart UART the esp01 is connected to, i.e. a RingUart so
+  ///        responses are received in the background
+  explicit Esp(sjsu::Uart & uart)
+      : esp_(std::in_place, uart),
+        wifi_(esp_->GetWiFi()),
+        socket_(esp_->GetInternetSocket())
+  {
+  }
+
+  /// Talks to a server through any network, i.e. host sockets when running
+  /// against a local mission control stand-in
+  /// @param wifi network the socket goes through
+  /// @param socket connection used for every request
+  /// @param url server host name or address
+  /// @param port server port for HTTP requests
+  Esp(sjsu::WiFi & wifi,
+      sjsu::InternetSocket & socket,
+      std::string_view url = kDefaultUrl,
+      uint16_t port        = kDefaultPort)
+      : wifi_(wifi), socket_(socket), url_(url), port_(port)
+  {
+  }
+
+  /// Initializes the Wi-Fi module. Does not wait for the network, the link
+  /// is brought up by MaintainLink().
   void Initialize()
   {
     sjsu::LogInfo("Initializing Wi-Fi module...");
-    esp_.Initialize();
-    ConnectToWiFi();
+    if (esp_)
+    {
+      esp_->Initialize();
+    }
   };
 
+  /// Keeps the WiFi link up, call before every request. Blocks for at most
+  /// one association attempt (WiFiLink::kAssociationTimeout) and otherwise
+  /// only compares times. Drops the server connection if the link is down.
+  /// @return true if the link is up and requests can be sent
+  bool MaintainLink()
+  {
+    if (!link_.Update())
+    {
+      DropConnection();
+      return false;
+    }
+    return true;
+  }
+
+  const WiFiLink & GetLink() const
+  {
+    return link_;
+  }
+
   /// Sends a GET request to the hardcoded URL
   /// @param endpoint i.e. /endpoint?example=parameter
-  /// @return the response body of the GET request
-  std::string_view GETRequest(std::string endpoint)
+  /// @param response_body buffer the response body is copied into
+  /// @return the response body of the GET request, stored in response_body
+  std::string_view GETRequest(std::string_view endpoint,
+                              std::span<char> response_body)
+  {
+    NewGETRequest().Append(endpoint);
+    return SendGETRequest(response_body);
+  };
+
+  /// Starts a new GET request in the request buffer. The caller appends the
+  /// endpoint and query parameters to the returned writer and then calls
+  /// SendGETRequest(). Nothing is allocated on the heap.
+  /// @return writer positioned right after "GET /"
+  RequestWriter & NewGETRequest()
+  {
+    request_.Clear();
+    request_.Append("GET /");
+    return request_;
+  }
+
+  /// Finishes the request started with NewGETRequest() and sends it to the
+  /// hardcoded URL over a persistent (keep-alive) connection. The TCP
+  /// connection is only re-established if the previous one was dropped or
+  /// closed by the server. Returns as soon as the full body has arrived.
+  /// @param response_body buffer the response body is copied into
+  /// @return the response body of the GET request, stored in response_body.
+  ///         Empty if the request failed or the server returned an error.
+  std::string_view SendGETRequest(std::span<char> response_body)
+  {
+    // Every byte goes over the esp's UART, so only the headers the server
+    // needs are sent. GET requests have no body to give a Content-Type.
+    request_.Append(" HTTP/1.1\r\nHost: ")
+        .Append(url_)
+        .Append("\r\nConnection: keep-alive\r\n\r\n");
+    if (request_.HasOverflowed())
+    {
+      sjsu::LogError("Request does not fit in %zu bytes, not sending!",
+                     request_.GetCapacity());
+      return "";
+    }
+
+    // A stale keep-alive socket is only discovered once we try to use it, so
+    // allow one retry on a fresh connection before giving up.
+    for (int attempt = 0; attempt < kMaxRequestAttempts; attempt++)
+    {
+      std::string_view body;
+      Status status =
+          Guard([&]() { return TryGETRequest(response_body, body); });
+      if (status == Status::kOk)
+      {
+        return body;
+      }
+      if (status == Status::kException)
+      {
+        sjsu::LogError("Request failed on attempt %d!", attempt + 1);
+        DropConnection();
+      }
+      else if (status != Status::kNoResponse)
+      {
+        return "";
+      }
+    }
+    // No attempt reached the server, check whether the network is still up
+    link_.ReportFailure();
+    return "";
+  };
+
+  /// Binary protocol alternative to GETRequest(). Sends a frame over a raw
+  /// TCP connection to kFramePort and waits for a reply of exactly
+  /// reply.size() bytes. Uses the same persistent connection handling as the
+  /// HTTP requests; switching between the two reconnects.
+  /// @param frame bytes to send
+  /// @param reply buffer for the reply frame
+  /// @return number of reply bytes received, reply.size() on success
+  size_t ExchangeFrame(std::span<const uint8_t> frame, std::span<uint8_t> reply)
+  {
+    for (int attempt = 0; attempt < kMaxRequestAttempts; attempt++)
+    {
+      size_t received = 0;
+      Status status =
+          Guard([&]() { return TryExchangeFrame(frame, reply, received); });
+      if (status == Status::kException)
+      {
+        sjsu::LogError("Frame exchange failed on attempt %d!", attempt + 1);
+        DropConnection();
+      }
+      else if (status != Status::kNoResponse)
+      {
+        return received;
+      }
+    }
+    link_.ReportFailure();
+    return 0;
+  }
+
+  /// @return true if a TCP connection to the server is currently held open
+  bool IsConnectedToServer() const
+  {
+    return is_connected_;
+  }
+
+  /// @return number of requests served by the currently open connection
+  uint32_t GetRequestsOnConnection() const
+  {
+    return requests_on_connection_;
+  }
+
+  /// @return number of TCP connections opened since initialization
+  uint32_t GetConnectionCount() const
   {
-    request_ = "GET /" + endpoint + " HTTP/1.1\r\nHost: " + url_ +
-               "\r\nContent-Type: application/json\r\n\r\n";
+    return connection_count_;
+  }
 
-    ConnectToServer();
+ private:
+  /// Sends the request once over the current or a new connection
+  /// @param response_body buffer the response body is copied into
+  /// @param body set to the response body on success
+  /// @return Status::kNoResponse if the connection was dropped and the
+  ///         request should be retried
+  Status TryGETRequest(std::span<char> response_body, std::string_view & body)
+  {
+    EnsureConnected(port_);
     WriteToServer();
 
     sjsu::LogInfo("Reading back response from server...");
-    std::array<uint8_t, 1024 * 2> response;
-    std::fill(response.begin(), response.end(), 0);
-    size_t read_back = socket_.Read(response, kDefaultTimeout);
-    std::string_view body(reinterpret_cast<char *>(response.data()), read_back);
+    HttpResponseParser parser(response_body);
+    ReadResponse(parser);
 
-    sjsu::LogInfo("Parsing response body for JSON...");
+    if (parser.GetBytesConsumed() == 0)
+    {
+      sjsu::LogWarning("Server did not respond, connection dropped?");
+      DropConnection();
+      return Status::kNoResponse;
+    }
+    requests_on_connection_++;
 
-    body = body.substr(body.find("\r\n\r\n"));
-    body = body.substr(body.find("{"));
-    return body.data();
-  };
+    // An incomplete response leaves unread bytes in the socket that would
+    // corrupt the next response, so the connection cannot be reused.
+    if (!parser.IsComplete() || !parser.IsKeepAlive())
+    {
+      DropConnection();
+    }
+    if (!parser.IsComplete())
+    {
+      sjsu::LogError("Incomplete response from server!");
+      return Status::kBadResponse;
+    }
+    if (parser.GetStatusCode() < 200 || parser.GetStatusCode() >= 300)
+    {
+      sjsu::LogError("Server responded with status %d!",
+                     static_cast<int>(parser.GetStatusCode()));
+      return Status::kBadResponse;
+    }
+    if (parser.IsTruncated())
+    {
+      sjsu::LogWarning("Response body truncated to %zu bytes!",
+                       response_body.size());
+    }
+    body = parser.GetBody();
+    return Status::kOk;
+  }
 
- private:
-  /// Attempts to connect to the local WiFi network
-  void ConnectToWiFi()
+  /// Exchanges one frame over the current or a new connection
+  /// @param received set to the number of reply bytes received
+  /// @return Status::kNoResponse if the connection was dropped and the
+  ///         exchange should be retried
+  Status TryExchangeFrame(std::span<const uint8_t> frame,
+                          std::span<uint8_t> reply,
+                          size_t & received)
   {
-    while (true)
+    EnsureConnected(kFramePort);
+    socket_.Write(frame, kDefaultTimeout);
+
+    sjsu::TimeoutTimer timer(kDefaultTimeout);
+    while (received < reply.size() && !timer.HasExpired())
     {
-      sjsu::LogInfo("Attempting to connect to %s...", kSsid);
-      if (wifi_.ConnectToAccessPoint(kSsid, kPassword, kDefaultTimeout))
+      size_t read_back =
+          socket_.Read(reply.subspan(received), timer.GetTimeLeft());
+      if (read_back == 0)
       {
-        break;
+        TaskDelay(kEmptyReadDelay);
       }
-      sjsu::LogError("Failed to connect to %s... Retrying...", kSsid);
-      wifi_.DisconnectFromAccessPoint();
+      received += read_back;
+    }
+
+    if (received == 0)
+    {
+      sjsu::LogWarning("Server did not respond, connection dropped?");
+      DropConnection();
+      return Status::kNoResponse;
+    }
+    requests_on_connection_++;
+    if (received < reply.size())
+    {
+      // The rest of the frame may still arrive and corrupt the next one
+      sjsu::LogError("Incomplete reply frame (%zu bytes)!", received);
+      DropConnection();
+      return Status::kBadResponse;
+    }
+    return Status::kOk;
+  }
+
+  /// Reuses the open connection if it is to the given port, otherwise
+  /// (re)connects
+  /// @param port server port the request is for
+  void EnsureConnected(uint16_t port)
+  {
+    if (is_connected_ && connected_port_ == port)
+    {
+      return;
     }
-    sjsu::LogInfo("Connected!");
+    DropConnection();
+    ConnectToServer(port);
   }
 
   /// Connects to the URL provided in member function
-  void ConnectToServer()
+  /// @param port server port to connect to
+  void ConnectToServer(uint16_t port)
   {
-    sjsu::LogInfo("Connecting to %s...", url_.data());
-    socket_.Connect(sjsu::InternetSocket::Protocol::kTCP, url_, kPort,
+    sjsu::LogInfo("Connecting to %s:%u...", url_.data(),
+                  static_cast<unsigned>(port));
+    socket_.Connect(sjsu::InternetSocket::Protocol::kTCP, url_, port,
                     kDefaultTimeout);
+    is_connected_           = true;
+    connected_port_         = port;
+    requests_on_connection_ = 0;
+    connection_count_++;
+  }
+
+  /// Closes the current server connection so the next request reconnects
+  void DropConnection()
+  {
+    if (!is_connected_)
+    {
+      return;
+    }
+    sjsu::LogInfo("Closing connection after %lu request(s)...",
+                  static_cast<unsigned long>(requests_on_connection_));
+    is_connected_ = false;
+    // Fails if the server already closed the socket, which is fine
+    Guard([this]() {
+      socket_.Close();
+      return Status::kOk;
+    });
   }
 
   /// Sends an HTTP request to the connected server
   void WriteToServer()
   {
     sjsu::LogInfo("Writing request to server...");
-    sjsu::LogInfo("%s", request_.c_str());
-    std::span write_payload(reinterpret_cast<const uint8_t *>(request_.data()),
-                            request_.size());
-    socket_.Write(write_payload, kDefaultTimeout);
+    sjsu::LogInfo("%.*s", static_cast<int>(request_.GetLength()),
+                  request_.GetView().data());
+    socket_.Write(request_.GetBytes(), kDefaultTimeout);
   }
 
-  /// Verifies that the Wi-Fi module is still connected to the network
-  /// @return true if the module is still connected to the internet
-  bool IsConnectedToWiFi()
+  /// Feeds socket reads into the parser until the response is complete or
+  /// the default timeout expires. The socket has no way to report that the
+  /// server closed the connection, so the timeout also ends a body without
+  /// a length.
+  /// @param parser parser for the response being read
+  void ReadResponse(HttpResponseParser & parser)
   {
-    if (!wifi_.IsConnected())  // TODO: Not implemented
+    std::array<uint8_t, kReadChunkSize> chunk;
+    sjsu::TimeoutTimer timer(kDefaultTimeout);
+    while (!parser.IsDone() && !timer.HasExpired())
     {
-      sjsu::LogError("Lost connection to %s... Reconnecting...", kSsid);
-      ConnectToWiFi();
-      if (!wifi_.IsConnected())
+      size_t read_back = socket_.Read(chunk, timer.GetTimeLeft());
+      if (read_back == 0)
       {
-        sjsu::LogError("Unable to reconnect to %s...", kSsid);
-        return false;
+        TaskDelay(kEmptyReadDelay);
+        continue;
       }
+      parser.Parse(std::span<const uint8_t>(chunk.data(), read_back));
     }
-    return true;
-  };
+    if (!parser.IsDone())
+    {
+      parser.ConnectionClosed();
+    }
+  }
+
+  static constexpr const char * kSsid     = "GarzaLine";
+  static constexpr const char * kPassword = "NRG523509";
 
-  sjsu::Esp8266 esp_;
+  std::optional<sjsu::Esp8266> esp_;
   sjsu::WiFi & wifi_;
   sjsu::InternetSocket & socket_;
-  std::string request_;
-  std::string url_       = "my-json-server.typicode.com";
-  const uint16_t kPort   = 80;
-  const char * kSsid     = "GarzaLine";
-  const char * kPassword = "NRG523509";
+  WiFiLink link_ = WiFiLink(wifi_, kSsid, kPassword);
+  StaticRequestWriter<kRequestCapacity> request_;
+  bool is_connected_               = false;
+  uint16_t connected_port_         = 0;
+  uint32_t requests_on_connection_ = 0;
+  uint32_t connection_count_       = 0;
+  std::string_view url_     = kDefaultUrl;
+  uint16_t port_            = kDefaultPort;
+  const uint16_t kFramePort = 5000;  // binary protocol frames
   const std::chrono::nanoseconds kDefaultTimeout = 3s;
+  /// Reads can come back empty before their timeout while nothing has
+  /// arrived, and it is not known whether the Esp8266 driver also returns
+  /// empty once the server closed the connection. Empty reads are retried
+  /// until the caller's timeout, waiting this long in between so other tasks
+  /// get the CPU.
+  const std::chrono::nanoseconds kEmptyReadDelay = 10ms;
+  const int kMaxRequestAttempts                   = 2;
 };
 }  // namespace sjsu::common
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace sjsu::common
+{
+/// FlightRecorder keeps the last kCapacity records of a control loop in RAM,
+/// one per tick, overwriting the oldest. Capturing is a single copy of the
+/// record, so it can run every tick for the whole mission.
+///
+/// When something goes wrong, Freeze() keeps the records leading up to it
+/// and Dump() prints them as hex lines between kBeginMarker and kEndMarker.
+/// The lines survive any serial console log; ParseDumpLine() turns them back
+/// into records on the host.
+///
+/// Record must be trivially copyable and made of fixed width fields laid out
+/// without padding, so the firmware and the host agree on its layout.
+///
+/// Only one task may Capture(). Freezing from another task is safe on a
+/// single core as long as the capturing task has the higher priority.
+template <typename Record, size_t kCapacity>
+class FlightRecorder
+{
+ public:
+  static_assert(std::is_trivially_copyable_v<Record>,
+                "Flight records must be trivially copyable");
+
+  static constexpr const char * kBeginMarker = "FLIGHT RECORDER BEGIN";
+  static constexpr const char * kEndMarker   = "FLIGHT RECORDER END";
+
+  /// Stores a record unless the recorder is frozen
+  void Capture(const Record & record)
+  {
+    if (is_frozen_.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+    records_[next_] = record;
+    next_           = (next_ + 1) % kCapacity;
+    if (count_ < kCapacity)
+    {
+      count_++;
+    }
+    captured_++;
+  }
+
+  /// Stops capturing so the current records are kept, i.e. on a fault
+  void Freeze()
+  {
+    is_frozen_.store(true, std::memory_order_relaxed);
+  }
+
+  /// Starts capturing again after Freeze()
+  void Resume()
+  {
+    is_frozen_.store(false, std::memory_order_relaxed);
+  }
+
+  bool IsFrozen() const
+  {
+    return is_frozen_.load(std::memory_order_relaxed);
+  }
+
+  /// Asks the task that prints the recorder to Dump() it. Freezes the
+  /// recorder right away so the records around the request are kept.
+  void RequestDump()
+  {
+    Freeze();
+    is_dump_requested_.store(true, std::memory_order_relaxed);
+  }
+
+  /// @return true once after each RequestDump()
+  bool TakeDumpRequest()
+  {
+    return is_dump_requested_.exchange(false, std::memory_order_relaxed);
+  }
+
+  /// @return number of records held, at most kCapacity
+  size_t GetCount() const
+  {
+    return count_;
+  }
+
+  /// @return total number of records captured
+  uint32_t GetCapturedCount() const
+  {
+    return captured_;
+  }
+
+  /// @param index 0 for the oldest record held, GetCount() - 1 for the newest
+  const Record & Get(size_t index) const
+  {
+    size_t oldest = (count_ < kCapacity) ? 0 : next_;
+    return records_[(oldest + index) % kCapacity];
+  }
+
+  /// Prints every record, oldest first, one hex line each. Freeze the
+  /// recorder first so the records do not change while they are printed.
+  /// @param write called with each null terminated line, without a newline
+  template <typename Writer>
+  void Dump(Writer write) const
+  {
+    // Marker, record size, record count
+    std::array<char, 64> header;
+    snprintf(header.data(), header.size(), "%s %zu %zu", kBeginMarker,
+             sizeof(Record), count_);
+    write(header.data());
+
+    std::array<char, 2 * sizeof(Record) + 1> line;
+    for (size_t i = 0; i < count_; i++)
+    {
+      const auto * bytes = reinterpret_cast<const uint8_t *>(&Get(i));
+      for (size_t byte = 0; byte < sizeof(Record); byte++)
+      {
+        line[2 * byte]     = kHexDigits[bytes[byte] >> 4];
+        line[2 * byte + 1] = kHexDigits[bytes[byte] & 0x0F];
+      }
+      line[2 * sizeof(Record)] = '\0';
+      write(line.data());
+    }
+    write(kEndMarker);
+  }
+
+  /// Decodes one record line printed by Dump()
+  /// @param line hex digits, surrounding whitespace is ignored
+  /// @param record set to the decoded record if the line is valid
+  /// @return false if the line is not a record of this type
+  static bool ParseDumpLine(std::string_view line, Record & record)
+  {
+    while (!line.empty() && IsSpace(line.front()))
+    {
+      line.remove_prefix(1);
+    }
+    while (!line.empty() && IsSpace(line.back()))
+    {
+      line.remove_suffix(1);
+    }
+    if (line.size() != 2 * sizeof(Record))
+    {
+      return false;
+    }
+
+    std::array<uint8_t, sizeof(Record)> bytes;
+    for (size_t byte = 0; byte < sizeof(Record); byte++)
+    {
+      int high = HexValue(line[2 * byte]);
+      int low  = HexValue(line[2 * byte + 1]);
+      if (high < 0 || low < 0)
+      {
+        return false;
+      }
+      bytes[byte] = static_cast<uint8_t>((high << 4) | low);
+    }
+    std::memcpy(&record, bytes.data(), sizeof(Record));
+    return true;
+  }
+
+ private:
+  static constexpr const char * kHexDigits = "0123456789ABCDEF";
+
+  static bool IsSpace(char character)
+  {
+    return character == ' ' || character == '\r' || character == '\n' ||
+           character == '\t';
+  }
+
+  static int HexValue(char digit)
+  {
+    if (digit >= '0' && digit <= '9')
+    {
+      return digit - '0';
+    }
+    if (digit >= 'A' && digit <= 'F')
+    {
+      return digit - 'A' + 10;
+    }
+    if (digit >= 'a' && digit <= 'f')
+    {
+      return digit - 'a' + 10;
+    }
+    return -1;
+  }
+
+  std::array<Record, kCapacity> records_ = {};
+  size_t next_                           = 0;
+  size_t count_                          = 0;
+  uint32_t captured_                     = 0;
+  std::atomic<bool> is_frozen_           = false;
+  std::atomic<bool> is_dump_requested_   = false;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "devices/communication/esp8266.hpp"
+
+namespace sjsu::common
+{
+/// InternetSocket backed by a POSIX socket, so Esp can run its request and
+/// parse path on a host against a local server. Host builds only.
+///
+/// Reads return whatever has arrived within the timeout. Once the server
+/// closed the connection they return 0 right away, without waiting for the
+/// timeout. Other errors are thrown.
+class HostSocket : public sjsu::InternetSocket
+{
+ public:
+  HostSocket() = default;
+  HostSocket(const HostSocket &) = delete;
+  HostSocket & operator=(const HostSocket &) = delete;
+
+  ~HostSocket()
+  {
+    Close();
+  }
+
+  void Connect(Protocol protocol,
+               std::string_view address,
+               uint16_t port,
+               std::chrono::nanoseconds timeout) override
+  {
+    Close();
+
+    addrinfo hints     = {};
+    hints.ai_family    = AF_UNSPEC;
+    hints.ai_socktype  = (protocol == Protocol::kTCP) ? SOCK_STREAM
+                                                      : SOCK_DGRAM;
+    addrinfo * results = nullptr;
+    std::string host(address);
+    std::string service = std::to_string(port);
+    int error = getaddrinfo(host.c_str(), service.c_str(), &hints, &results);
+    if (error != 0)
+    {
+      throw std::system_error(std::make_error_code(std::errc::host_unreachable),
+                              gai_strerror(error));
+    }
+
+    int last_error = ECONNREFUSED;
+    for (addrinfo * entry = results; entry != nullptr; entry = entry->ai_next)
+    {
+      last_error = TryConnect(*entry, timeout);
+      if (last_error == 0)
+      {
+        break;
+      }
+    }
+    freeaddrinfo(results);
+    if (last_error != 0)
+    {
+      throw std::system_error(last_error, std::generic_category(), host);
+    }
+
+    if (protocol == Protocol::kTCP)
+    {
+      // Requests are written in one go, waiting to batch them only adds
+      // latency
+      int enable = 1;
+      setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+  }
+
+  void Write(std::span<const uint8_t> buffer,
+             std::chrono::nanoseconds timeout) override
+  {
+    while (!buffer.empty())
+    {
+      if (!Wait(POLLOUT, timeout))
+      {
+        throw std::system_error(std::make_error_code(std::errc::timed_out),
+                                "write");
+      }
+      ssize_t sent = send(fd_, buffer.data(), buffer.size(), MSG_NOSIGNAL);
+      if (sent < 0)
+      {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        {
+          continue;
+        }
+        throw std::system_error(errno, std::generic_category(), "write");
+      }
+      buffer = buffer.subspan(static_cast<size_t>(sent));
+    }
+  }
+
+  size_t Read(std::span<uint8_t> buffer,
+              std::chrono::nanoseconds timeout) override
+  {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (Wait(POLLIN, deadline - std::chrono::steady_clock::now()))
+    {
+      ssize_t received = recv(fd_, buffer.data(), buffer.size(), 0);
+      if (received >= 0)
+      {
+        // 0 once the server closed the connection
+        return static_cast<size_t>(received);
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+      {
+        throw std::system_error(errno, std::generic_category(), "read");
+      }
+    }
+    return 0;
+  }
+
+  void Close() override
+  {
+    if (fd_ >= 0)
+    {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+ private:
+  /// @return 0 once connected, otherwise the errno of the failure
+  int TryConnect(const addrinfo & address, std::chrono::nanoseconds timeout)
+  {
+    fd_ = socket(address.ai_family, address.ai_socktype, address.ai_protocol);
+    if (fd_ < 0)
+    {
+      return errno;
+    }
+    // Non-blocking so that connecting, reading and writing honor timeouts
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+
+    int error = 0;
+    if (connect(fd_, address.ai_addr, address.ai_addrlen) != 0)
+    {
+      error = errno;
+      if (error == EINPROGRESS)
+      {
+        error = ETIMEDOUT;
+        if (Wait(POLLOUT, timeout))
+        {
+          socklen_t length = sizeof(error);
+          getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &length);
+        }
+      }
+    }
+    if (error != 0)
+    {
+      Close();
+    }
+    return error;
+  }
+
+  /// @return true if the socket became ready for events within the timeout
+  bool Wait(short events, std::chrono::nanoseconds timeout)
+  {
+    if (fd_ < 0)
+    {
+      throw std::system_error(std::make_error_code(std::errc::not_connected),
+                              "socket");
+    }
+    pollfd descriptor = { .fd = fd_, .events = events, .revents = 0 };
+    auto milliseconds =
+        std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+    int ready = poll(&descriptor, 1, static_cast<int>(milliseconds));
+    return ready > 0;
+  }
+
+  int fd_ = -1;
+};
+
+/// WiFi stand-in for hosts, which are always on a network
+class HostWiFi : public sjsu::WiFi
+{
+ public:
+  bool ConnectToAccessPoint(std::string_view,
+                            std::string_view,
+                            std::chrono::nanoseconds) override
+  {
+    is_connected_ = true;
+    return true;
+  }
+
+  void DisconnectFromAccessPoint() override
+  {
+    is_connected_ = false;
+  }
+
+  bool IsConnected() override
+  {
+    return is_connected_;
+  }
+
+ private:
+  bool is_connected_ = false;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace sjsu::common
+{
+/// HttpResponseParser incrementally parses an HTTP/1.1 response as its bytes
+/// arrive, so a response split across any number of socket reads can be
+/// handled without buffering the whole thing. Supports Content-Length,
+/// chunked and read-until-close bodies. The body is copied into a buffer
+/// owned by the caller.
+class HttpResponseParser
+{
+ public:
+  enum class State : uint8_t
+  {
+    kStatusLine,
+    kHeaders,
+    kBody,
+    kBodyUntilClose,
+    kChunkSize,
+    kChunkData,
+    kChunkDataEnd,
+    kTrailers,
+    kComplete,
+    kError,
+  };
+
+  /// Longest status or header line kept. Longer lines are truncated, which is
+  /// fine since only the start of the few headers we care about is checked.
+  static constexpr size_t kMaxLineLength = 128;
+
+  /// @param body buffer the response body is copied into
+  explicit HttpResponseParser(std::span<char> body)
+  {
+    Reset(body);
+  }
+
+  /// Prepares the parser for a new response
+  /// @param body buffer the response body is copied into
+  void Reset(std::span<char> body)
+  {
+    body_           = body;
+    body_length_    = 0;
+    state_          = State::kStatusLine;
+    line_length_    = 0;
+    status_code_    = 0;
+    remaining_      = 0;
+    content_length_ = -1;
+    is_chunked_     = false;
+    is_keep_alive_  = true;
+    is_truncated_   = false;
+    bytes_consumed_ = 0;
+  }
+
+  /// Feeds newly received bytes into the parser. Parsing stops as soon as the
+  /// response is complete, any bytes after that are not consumed.
+  /// @param data bytes read from the socket
+  /// @return number of bytes consumed from data
+  size_t Parse(std::span<const uint8_t> data)
+  {
+    size_t position = 0;
+    while (position < data.size() && !IsDone())
+    {
+      switch (state_)
+      {
+        case State::kBody:
+        case State::kChunkData:
+        case State::kBodyUntilClose:
+          position += ConsumeBody(data.subspan(position));
+          break;
+        default:
+          if (ConsumeLineCharacter(static_cast<char>(data[position++])))
+          {
+            HandleLine(std::string_view(line_.data(), line_length_));
+            line_length_ = 0;
+          }
+          break;
+      }
+    }
+    bytes_consumed_ += position;
+    return position;
+  }
+
+  /// Lets the parser know the server closed the connection. Completes a body
+  /// that is delimited by the connection closing, anything else is an error.
+  void ConnectionClosed()
+  {
+    if (state_ == State::kBodyUntilClose)
+    {
+      state_ = State::kComplete;
+    }
+    else if (state_ != State::kComplete)
+    {
+      state_ = State::kError;
+    }
+    is_keep_alive_ = false;
+  }
+
+  /// @return true once the parser will not accept any more bytes
+  bool IsDone() const
+  {
+    return state_ == State::kComplete || state_ == State::kError;
+  }
+
+  bool IsComplete() const
+  {
+    return state_ == State::kComplete;
+  }
+
+  bool HasError() const
+  {
+    return state_ == State::kError;
+  }
+
+  State GetState() const
+  {
+    return state_;
+  }
+
+  /// @return status code of the response i.e. 200, 0 until it has been read
+  int32_t GetStatusCode() const
+  {
+    return status_code_;
+  }
+
+  /// @return false if the server will close the connection after responding
+  bool IsKeepAlive() const
+  {
+    return is_keep_alive_;
+  }
+
+  /// @return true if the body did not fit in the caller's buffer
+  bool IsTruncated() const
+  {
+    return is_truncated_;
+  }
+
+  /// @return total number of bytes consumed since the last Reset()
+  size_t GetBytesConsumed() const
+  {
+    return bytes_consumed_;
+  }
+
+  /// @return the body received so far, stored in the caller's buffer
+  std::string_view GetBody() const
+  {
+    return std::string_view(body_.data(), body_length_);
+  }
+
+ private:
+  /// Accumulates a line, ignoring the trailing CR.
+  /// @return true once a complete line has been received
+  bool ConsumeLineCharacter(char character)
+  {
+    if (character == '\n')
+    {
+      return true;
+    }
+    if (character != '\r' && line_length_ < line_.size())
+    {
+      line_[line_length_++] = character;
+    }
+    return false;
+  }
+
+  void HandleLine(std::string_view line)
+  {
+    switch (state_)
+    {
+      case State::kStatusLine: HandleStatusLine(line); break;
+      case State::kHeaders: HandleHeaderLine(line); break;
+      case State::kChunkSize: HandleChunkSizeLine(line); break;
+      case State::kChunkDataEnd:
+        state_ = line.empty() ? State::kChunkSize : State::kError;
+        break;
+      case State::kTrailers:
+        if (line.empty())
+        {
+          state_ = State::kComplete;
+        }
+        break;
+      default: state_ = State::kError; break;
+    }
+  }
+
+  /// Parses "HTTP/1.1 200 OK"
+  void HandleStatusLine(std::string_view line)
+  {
+    if (line.empty())
+    {
+      return;  // Tolerate stray blank lines before the status line
+    }
+    if (line.substr(0, 5) != "HTTP/")
+    {
+      state_ = State::kError;
+      return;
+    }
+    // HTTP/1.0 closes the connection by default
+    is_keep_alive_ = line.substr(0, 8) != "HTTP/1.0";
+
+    size_t space = line.find(' ');
+    if (space == std::string_view::npos ||
+        !ParseDecimal(line.substr(space + 1, 3), &status_code_))
+    {
+      state_ = State::kError;
+      return;
+    }
+    state_ = State::kHeaders;
+  }
+
+  void HandleHeaderLine(std::string_view line)
+  {
+    if (line.empty())
+    {
+      FinishHeaders();
+      return;
+    }
+
+    size_t colon = line.find(':');
+    if (colon == std::string_view::npos)
+    {
+      return;  // Malformed header, ignore it
+    }
+    std::string_view name  = line.substr(0, colon);
+    std::string_view value = TrimLeadingSpaces(line.substr(colon + 1));
+
+    if (EqualsIgnoreCase(name, "Content-Length"))
+    {
+      int32_t length;
+      if (!ParseDecimal(value, &length))
+      {
+        state_ = State::kError;
+        return;
+      }
+      content_length_ = length;
+    }
+    else if (EqualsIgnoreCase(name, "Transfer-Encoding"))
+    {
+      is_chunked_ = ContainsIgnoreCase(value, "chunked");
+    }
+    else if (EqualsIgnoreCase(name, "Connection"))
+    {
+      if (ContainsIgnoreCase(value, "close"))
+      {
+        is_keep_alive_ = false;
+      }
+      else if (ContainsIgnoreCase(value, "keep-alive"))
+      {
+        is_keep_alive_ = true;
+      }
+    }
+  }
+
+  void FinishHeaders()
+  {
+    // 1xx responses are followed by the real response
+    if (status_code_ >= 100 && status_code_ < 200)
+    {
+      state_          = State::kStatusLine;
+      content_length_ = -1;
+      is_chunked_     = false;
+      return;
+    }
+    // These never have a body
+    if (status_code_ == 204 || status_code_ == 304)
+    {
+      state_ = State::kComplete;
+      return;
+    }
+
+    if (is_chunked_)
+    {
+      state_ = State::kChunkSize;
+    }
+    else if (content_length_ >= 0)
+    {
+      remaining_ = static_cast<size_t>(content_length_);
+      state_     = (remaining_ == 0) ? State::kComplete : State::kBody;
+    }
+    else
+    {
+      // Without a length the body ends when the server closes the socket
+      is_keep_alive_ = false;
+      state_         = State::kBodyUntilClose;
+    }
+  }
+
+  /// Parses a chunk size line i.e. "1a" or "1a;extension=value"
+  void HandleChunkSizeLine(std::string_view line)
+  {
+    line = line.substr(0, line.find(';'));
+    if (line.empty())
+    {
+      state_ = State::kError;
+      return;
+    }
+
+    size_t size = 0;
+    for (char character : TrimTrailingSpaces(line))
+    {
+      int digit = HexValue(character);
+      if (digit < 0 || size > (SIZE_MAX >> 4))
+      {
+        state_ = State::kError;
+        return;
+      }
+      size = (size << 4) | static_cast<size_t>(digit);
+    }
+
+    remaining_ = size;
+    state_     = (size == 0) ? State::kTrailers : State::kChunkData;
+  }
+
+  /// Copies as much of the body as is available
+  /// @return number of bytes consumed
+  size_t ConsumeBody(std::span<const uint8_t> data)
+  {
+    size_t length = data.size();
+    if (state_ != State::kBodyUntilClose)
+    {
+      length = std::min(length, remaining_);
+    }
+
+    size_t space  = body_.size() - body_length_;
+    size_t copied = std::min(length, space);
+    std::copy_n(data.begin(), copied, body_.begin() + body_length_);
+    body_length_ += copied;
+    if (copied < length)
+    {
+      is_truncated_ = true;
+    }
+
+    if (state_ != State::kBodyUntilClose)
+    {
+      remaining_ -= length;
+      if (remaining_ == 0)
+      {
+        state_ = (state_ == State::kBody) ? State::kComplete
+                                          : State::kChunkDataEnd;
+      }
+    }
+    return length;
+  }
+
+  static bool ParseDecimal(std::string_view text, int32_t * value)
+  {
+    int32_t result = 0;
+    size_t digits  = 0;
+    for (char character : text)
+    {
+      if (character < '0' || character > '9')
+      {
+        break;
+      }
+      if (result > (INT32_MAX - 9) / 10)
+      {
+        return false;
+      }
+      result = result * 10 + (character - '0');
+      digits++;
+    }
+    *value = result;
+    return digits > 0;
+  }
+
+  static int HexValue(char character)
+  {
+    if (character >= '0' && character <= '9')
+    {
+      return character - '0';
+    }
+    if (character >= 'a' && character <= 'f')
+    {
+      return character - 'a' + 10;
+    }
+    if (character >= 'A' && character <= 'F')
+    {
+      return character - 'A' + 10;
+    }
+    return -1;
+  }
+
+  static char ToLower(char character)
+  {
+    return (character >= 'A' && character <= 'Z') ? character - 'A' + 'a'
+                                                   : character;
+  }
+
+  static bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+  {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+             return ToLower(x) == ToLower(y);
+           });
+  }
+
+  static bool ContainsIgnoreCase(std::string_view text, std::string_view word)
+  {
+    for (size_t i = 0; i + word.size() <= text.size(); i++)
+    {
+      if (EqualsIgnoreCase(text.substr(i, word.size()), word))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static std::string_view TrimLeadingSpaces(std::string_view text)
+  {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    {
+      text.remove_prefix(1);
+    }
+    return text;
+  }
+
+  static std::string_view TrimTrailingSpaces(std::string_view text)
+  {
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+    {
+      text.remove_suffix(1);
+    }
+    return text;
+  }
+
+  std::span<char> body_;
+  size_t body_length_ = 0;
+  State state_        = State::kStatusLine;
+  std::array<char, kMaxLineLength> line_;
+  size_t line_length_     = 0;
+  int32_t status_code_    = 0;
+  size_t remaining_       = 0;
+  int32_t content_length_ = -1;
+  bool is_chunked_        = false;
+  bool is_keep_alive_     = true;
+  bool is_truncated_      = false;
+  size_t bytes_consumed_  = 0;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,404 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace sjsu::common
+{
+/// A single JSON value found by JsonReader. The text is a view into the
+/// buffer being read, nothing is copied.
+struct JsonValue
+{
+  enum class Type : uint8_t
+  {
+    kString,
+    kNumber,
+    kBoolean,
+    kNull,
+    kObject,
+    kArray,
+  };
+
+  Type type;
+  /// Contents of strings (without quotes or escape decoding), the literal
+  /// text of numbers/booleans/null, and the raw text of objects and arrays
+  /// including their braces.
+  std::string_view text;
+
+  /// Converts a number value, i.e. -12.5e-1. Uses single precision float
+  /// math only, no strtod/sscanf.
+  /// @param value set on success
+  /// @return false if this is not a valid number
+  bool ToFloat(float & value) const
+  {
+    constexpr std::array<float, 11> kPowersOfTen = {
+      1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+    if (type != Type::kNumber)
+    {
+      return false;
+    }
+
+    std::string_view number = text;
+    bool negative           = !number.empty() && number.front() == '-';
+    if (negative)
+    {
+      number.remove_prefix(1);
+    }
+
+    // Keep at most 9 significant digits so the mantissa fits in 32 bits,
+    // which is more than a float can represent anyway.
+    uint32_t mantissa = 0;
+    int significant   = 0;
+    int exponent      = 0;
+    int digits        = 0;
+    size_t i          = 0;
+    auto take_digit   = [&](char character, bool is_fraction) {
+      if (significant < 9)
+      {
+        if (mantissa != 0 || character != '0')
+        {
+          significant++;
+        }
+        mantissa = mantissa * 10 + static_cast<uint32_t>(character - '0');
+        exponent -= is_fraction;
+      }
+      else if (!is_fraction)
+      {
+        exponent++;
+      }
+      digits++;
+    };
+
+    for (; i < number.size() && IsDigit(number[i]); i++)
+    {
+      take_digit(number[i], false);
+    }
+    if (i < number.size() && number[i] == '.')
+    {
+      for (i++; i < number.size() && IsDigit(number[i]); i++)
+      {
+        take_digit(number[i], true);
+      }
+    }
+    if (digits == 0)
+    {
+      return false;
+    }
+    if (i < number.size() && (number[i] == 'e' || number[i] == 'E'))
+    {
+      i++;
+      bool negative_exponent = i < number.size() && number[i] == '-';
+      if (i < number.size() && (number[i] == '-' || number[i] == '+'))
+      {
+        i++;
+      }
+      int explicit_exponent = 0;
+      size_t start          = i;
+      for (; i < number.size() && IsDigit(number[i]); i++)
+      {
+        explicit_exponent =
+            (explicit_exponent < 100)
+                ? explicit_exponent * 10 + (number[i] - '0')
+                : explicit_exponent;
+      }
+      if (i == start)
+      {
+        return false;
+      }
+      exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+    if (i != number.size())
+    {
+      return false;
+    }
+
+    float result = static_cast<float>(mantissa);
+    while (exponent > 0)
+    {
+      int step = (exponent < 10) ? exponent : 10;
+      result *= kPowersOfTen[step];
+      exponent -= step;
+    }
+    while (exponent < 0)
+    {
+      int step = (-exponent < 10) ? -exponent : 10;
+      result /= kPowersOfTen[step];
+      exponent += step;
+    }
+    value = negative ? -result : result;
+    return true;
+  }
+
+  /// Converts a whole number value, i.e. -12
+  /// @param value set on success
+  /// @return false if this is not a valid whole number
+  bool ToInteger(int32_t & value) const
+  {
+    if (type != Type::kNumber)
+    {
+      return false;
+    }
+    std::string_view number = text;
+    bool negative           = !number.empty() && number.front() == '-';
+    if (negative)
+    {
+      number.remove_prefix(1);
+    }
+    if (number.empty() || number.size() > 9)
+    {
+      return false;
+    }
+    int32_t result = 0;
+    for (char character : number)
+    {
+      if (!IsDigit(character))
+      {
+        return false;
+      }
+      result = result * 10 + (character - '0');
+    }
+    value = negative ? -result : result;
+    return true;
+  }
+
+  /// Converts true/false, or a number where non-zero is true
+  /// @param value set on success
+  /// @return false if this is neither a boolean nor a whole number
+  bool ToBoolean(bool & value) const
+  {
+    if (type == Type::kBoolean)
+    {
+      value = (text == "true");
+      return true;
+    }
+    int32_t number;
+    if (ToInteger(number))
+    {
+      value = (number != 0);
+      return true;
+    }
+    return false;
+  }
+
+  static bool IsDigit(char character)
+  {
+    return character >= '0' && character <= '9';
+  }
+};
+
+/// JsonReader walks the "key": value pairs of a JSON object in a single pass
+/// without allocating or copying. Nested objects and arrays are returned as
+/// one raw value and can be read with another JsonReader.
+///
+/// Usage:
+///
+///     JsonReader reader(R"({"speed": 10.5, "mode": "D"})");
+///     while (reader.Next())
+///     {
+///       if (reader.GetKey() == "speed") { reader.GetValue().ToFloat(...); }
+///     }
+///     if (reader.HasError()) { ... }
+class JsonReader
+{
+ public:
+  /// @param json text of a JSON object, leading text before '{' is skipped
+  explicit JsonReader(std::string_view json) : json_(json)
+  {
+    position_ = json_.find('{');
+    if (position_ == std::string_view::npos)
+    {
+      has_error_ = true;
+      return;
+    }
+    position_++;
+  }
+
+  /// Advances to the next key/value pair of the object
+  /// @return false at the end of the object or if the JSON is malformed
+  bool Next()
+  {
+    if (has_error_ || is_finished_)
+    {
+      return false;
+    }
+
+    SkipWhitespace();
+    if (Peek() == '}')
+    {
+      is_finished_ = true;
+      return false;
+    }
+    if (has_pair_)
+    {
+      if (Peek() != ',')
+      {
+        return Fail();
+      }
+      position_++;
+      SkipWhitespace();
+    }
+
+    if (Peek() != '"' || !ReadString(key_))
+    {
+      return Fail();
+    }
+    SkipWhitespace();
+    if (Peek() != ':')
+    {
+      return Fail();
+    }
+    position_++;
+    SkipWhitespace();
+    if (!ReadValue())
+    {
+      return Fail();
+    }
+    has_pair_ = true;
+    return true;
+  }
+
+  std::string_view GetKey() const
+  {
+    return key_;
+  }
+
+  const JsonValue & GetValue() const
+  {
+    return value_;
+  }
+
+  /// @return true if the object was malformed or truncated
+  bool HasError() const
+  {
+    return has_error_;
+  }
+
+ private:
+  char Peek() const
+  {
+    return (position_ < json_.size()) ? json_[position_] : '\0';
+  }
+
+  bool Fail()
+  {
+    has_error_ = true;
+    return false;
+  }
+
+  void SkipWhitespace()
+  {
+    while (position_ < json_.size() &&
+           (json_[position_] == ' ' || json_[position_] == '\n' ||
+            json_[position_] == '\r' || json_[position_] == '\t'))
+    {
+      position_++;
+    }
+  }
+
+  /// Reads a quoted string starting at the opening quote
+  bool ReadString(std::string_view & contents)
+  {
+    size_t start = ++position_;
+    while (position_ < json_.size() && json_[position_] != '"')
+    {
+      // Skip over the escaped character so \" does not end the string
+      position_ += (json_[position_] == '\\') ? 2 : 1;
+    }
+    if (position_ >= json_.size())
+    {
+      return false;
+    }
+    contents = json_.substr(start, position_ - start);
+    position_++;
+    return true;
+  }
+
+  bool ReadValue()
+  {
+    char first = Peek();
+    if (first == '"')
+    {
+      value_.type = JsonValue::Type::kString;
+      return ReadString(value_.text);
+    }
+    if (first == '{' || first == '[')
+    {
+      value_.type = (first == '{') ? JsonValue::Type::kObject
+                                   : JsonValue::Type::kArray;
+      return ReadNested();
+    }
+
+    size_t start = position_;
+    while (position_ < json_.size() && json_[position_] != ',' &&
+           json_[position_] != '}' && json_[position_] != ' ' &&
+           json_[position_] != '\n' && json_[position_] != '\r' &&
+           json_[position_] != '\t')
+    {
+      position_++;
+    }
+    value_.text = json_.substr(start, position_ - start);
+    if (value_.text.empty())
+    {
+      return false;
+    }
+    if (value_.text == "true" || value_.text == "false")
+    {
+      value_.type = JsonValue::Type::kBoolean;
+    }
+    else if (value_.text == "null")
+    {
+      value_.type = JsonValue::Type::kNull;
+    }
+    else
+    {
+      value_.type = JsonValue::Type::kNumber;
+    }
+    return true;
+  }
+
+  /// Skips over a nested object or array, keeping its raw text
+  bool ReadNested()
+  {
+    size_t start = position_;
+    int depth    = 0;
+    while (position_ < json_.size())
+    {
+      char character = json_[position_];
+      if (character == '"')
+      {
+        std::string_view ignored;
+        if (!ReadString(ignored))
+        {
+          return false;
+        }
+        continue;
+      }
+      position_++;
+      if (character == '{' || character == '[')
+      {
+        depth++;
+      }
+      else if (character == '}' || character == ']')
+      {
+        if (--depth == 0)
+        {
+          value_.text = json_.substr(start, position_ - start);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  std::string_view json_;
+  size_t position_ = 0;
+  std::string_view key_;
+  JsonValue value_  = { JsonValue::Type::kNull, {} };
+  bool has_pair_    = false;
+  bool has_error_   = false;
+  bool is_finished_ = false;
+};
+}  // namespace sjsu::common
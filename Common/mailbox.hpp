@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace sjsu::common
+{
+/// Mailbox passes the latest value from one producer task to one consumer
+/// task without locks or blocking (a triple buffer). The producer can write
+/// as often as it likes and the consumer always reads the newest complete
+/// value; older unread values are overwritten, never queued.
+///
+/// Only one task may call Write() and only one task may call Read().
+template <typename T>
+class Mailbox
+{
+ public:
+  /// Publishes a new value. Never blocks.
+  void Write(const T & value)
+  {
+    buffers_[back_] = value;
+    // Hand the filled buffer to the consumer and take back whichever buffer
+    // it is not reading.
+    uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh),
+                                        std::memory_order_acq_rel);
+    back_            = previous & kIndexMask;
+    writes_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Copies out the newest value. Never blocks.
+  /// @param value set to the newest value written, or the last value read if
+  ///        nothing new has been written since
+  /// @return true if value is new since the previous Read()
+  bool Read(T & value)
+  {
+    bool is_fresh = (middle_.load(std::memory_order_acquire) & kFresh) != 0;
+    if (is_fresh)
+    {
+      uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+      front_           = previous & kIndexMask;
+    }
+    value = buffers_[front_];
+    return is_fresh;
+  }
+
+  /// @return true if a value was written that has not been read yet
+  bool HasNewValue() const
+  {
+    return (middle_.load(std::memory_order_acquire) & kFresh) != 0;
+  }
+
+  /// @return total number of values written
+  uint32_t GetWriteCount() const
+  {
+    return writes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x03;
+  static constexpr uint8_t kFresh     = 0x04;
+
+  std::array<T, 3> buffers_ = {};
+  /// Owned by the producer
+  uint8_t back_ = 0;
+  /// Shared, index of the spare buffer plus the kFresh flag
+  std::atomic<uint8_t> middle_ = 1;
+  /// Owned by the consumer
+  uint8_t front_ = 2;
+  std::atomic<uint32_t> writes_ = 0;
+};
+}  // namespace sjsu::common
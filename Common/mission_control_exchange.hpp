@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "utility/log.hpp"
+#include "esp.hpp"
+#include "json_reader.hpp"
+#include "request_writer.hpp"
+#include "status.hpp"
+
+namespace sjsu::common
+{
+/// A subsystem (i.e. drive or arm) that reports telemetry to and takes
+/// commands from mission control through a MissionControlExchange
+class MissionControlClient
+{
+ public:
+  virtual ~MissionControlClient() = default;
+
+  /// @return name that marks the subsystem's query parameters and is its key
+  ///         in the response, i.e. "drive"
+  virtual std::string_view GetName() const = 0;
+
+  /// @return endpoint mission control serves the subsystem at on its own,
+  ///         i.e. "Vishnu-Adda/json-robo-test/drive"
+  virtual std::string_view GetEndpoint() const = 0;
+
+  /// Appends the subsystem's telemetry as query parameters
+  virtual void WriteTelemetry(RequestWriter & request) = 0;
+
+  /// Applies the subsystem's commands
+  /// @param json the subsystem's object from the response,
+  ///        i.e. {"is_operational": 1, "drive_mode": "D"...}
+  /// @return Status::kOk if commands were applied
+  virtual Status ReceiveCommands(std::string_view json) = 0;
+};
+
+/// MissionControlExchange talks to mission control for every subsystem
+/// running on the board with one round-trip per cycle.
+///
+/// With a single client, the request goes to the client's own endpoint with
+/// only its telemetry, and the whole response is its commands, just as if
+/// the subsystem talked to mission control by itself:
+///
+///     GET /.../drive?drive_mode=D...
+///
+/// With more clients, their telemetry goes in a single request to kEndpoint,
+/// each client's parameters following a subsystem parameter with its name:
+///
+///     GET /.../rover?subsystem=drive&drive_mode=D...&subsystem=arm&rotunda=...
+///
+/// Mission control answers with one object per subsystem, which is handed to
+/// the client of the same name:
+///
+///     {"drive": {"drive_mode": "D", ...}, "arm": {"rotunda": 30, ...}}
+///
+/// So far only the local stand-in (Common/tools/mission_control_server)
+/// serves kEndpoint, so a board only batches once a second client is added.
+class MissionControlExchange
+{
+ public:
+  static constexpr size_t kMaxClients = 4;
+  /// Endpoint all clients are served at together, with two or more clients
+  static constexpr std::string_view kEndpoint =
+      "Vishnu-Adda/json-robo-test/rover";
+  /// Query parameter each client's telemetry starts with
+  static constexpr std::string_view kSubsystemParameter = "subsystem";
+
+  explicit MissionControlExchange(Esp & esp) : esp_(esp) {}
+
+  /// Registers a client, clients are written in the order they were added
+  /// @return false if kMaxClients clients have already been added
+  bool AddClient(MissionControlClient & client)
+  {
+    if (client_count_ >= kMaxClients)
+    {
+      sjsu::LogError("Cannot add client %.*s, exchange is full!",
+                     static_cast<int>(client.GetName().size()),
+                     client.GetName().data());
+      return false;
+    }
+    clients_[client_count_++] = &client;
+    return true;
+  }
+
+  /// Initializes the Wi-Fi module
+  void Initialize()
+  {
+    esp_.Initialize();
+  }
+
+  /// Sends the telemetry of every client and hands each the commands that
+  /// came back
+  /// @return Status::kOk if every client applied its commands
+  Status Exchange()
+  {
+    // While the WiFi reconnects no commands arrive, so each subsystem has to
+    // stop on its own once its last command is too old
+    if (!esp_.MaintainLink())
+    {
+      return Status::kNoResponse;
+    }
+    WriteRequest(esp_.NewGETRequest());
+    std::string_view response = esp_.SendGETRequest(response_body_);
+    if (response.empty())
+    {
+      return Status::kNoResponse;
+    }
+    return DispatchResponse(response);
+  }
+
+  /// Appends the endpoint and the telemetry of every client
+  /// @param request writer positioned where the endpoint goes
+  void WriteRequest(RequestWriter & request)
+  {
+    if (client_count_ == 1)
+    {
+      request.Append(clients_[0]->GetEndpoint());
+      clients_[0]->WriteTelemetry(request);
+      return;
+    }
+    request.Append(kEndpoint);
+    for (size_t i = 0; i < client_count_; i++)
+    {
+      request.AppendParameterName(kSubsystemParameter)
+          .Append(clients_[i]->GetName());
+      clients_[i]->WriteTelemetry(request);
+    }
+  }
+
+  /// Hands each client its object from the response, or the whole response
+  /// to a single client. Keys that match no client are ignored.
+  /// @param json response body
+  /// @return Status::kOk if every client applied its commands, otherwise
+  ///         the first client failure, Status::kBadResponse if a client's
+  ///         object was missing
+  Status DispatchResponse(std::string_view json)
+  {
+    if (client_count_ == 1)
+    {
+      return clients_[0]->ReceiveCommands(json);
+    }
+
+    std::array<Status, kMaxClients> statuses;
+    statuses.fill(Status::kBadResponse);
+
+    JsonReader reader(json);
+    while (reader.Next())
+    {
+      const JsonValue & value = reader.GetValue();
+      for (size_t i = 0; i < client_count_; i++)
+      {
+        if (reader.GetKey() == clients_[i]->GetName() &&
+            value.type == JsonValue::Type::kObject)
+        {
+          statuses[i] = clients_[i]->ReceiveCommands(value.text);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < client_count_; i++)
+    {
+      if (statuses[i] != Status::kOk)
+      {
+        return statuses[i];
+      }
+    }
+    return Status::kOk;
+  }
+
+  size_t GetClientCount() const
+  {
+    return client_count_;
+  }
+
+ private:
+  Esp & esp_;
+  std::array<MissionControlClient *, kMaxClients> clients_ = {};
+  size_t client_count_                                     = 0;
+  std::array<char, 1024> response_body_;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "utility/log.hpp"
+#include "utility/time/time.hpp"
+#include "deferred_log.hpp"
+#include "task_delay.hpp"
+#include "timing_statistics.hpp"
+
+namespace sjsu::common
+{
+/// PeriodicExecutive runs a fixed set of steps once per period at absolute
+/// deadlines (start + n * period), so the period does not drift with how
+/// long each cycle takes. It measures every step's execution time and the
+/// lateness of every cycle start (jitter), and counts overruns against the
+/// period and optional per-step budgets.
+///
+/// Usage:
+///
+///     PeriodicExecutive<4> executive(10ms);
+///     executive.AddStep("drive", [&]() { drive.HandleRoverMovement(); });
+///     while (true)
+///     {
+///       executive.RunCycle();  // runs the steps then waits for the deadline
+///     }
+template <size_t kMaxSteps>
+class PeriodicExecutive
+{
+ public:
+  using UptimeFunction = std::chrono::nanoseconds (*)();
+  using DelayFunction  = void (*)(std::chrono::nanoseconds);
+
+  struct Step
+  {
+    const char * name = "";
+    std::function<void()> function;
+    /// 0ns for no budget
+    std::chrono::nanoseconds budget = 0ns;
+    TimingStatistics execution_time;
+    uint32_t overruns = 0;
+  };
+
+  /// @param period time between the start of each cycle
+  /// @param uptime clock used for deadlines and measurements
+  /// @param delay waits for a duration, must block the task when running
+  ///        under the scheduler so lower priority tasks get the CPU
+  explicit PeriodicExecutive(std::chrono::nanoseconds period,
+                             UptimeFunction uptime = sjsu::Uptime,
+                             DelayFunction delay   = TaskDelay)
+      : period_(period), uptime_(uptime), delay_(delay)
+  {
+  }
+
+  /// Registers a step, steps run in the order they were added.
+  /// @param name shown in reports, must outlive the executive and any
+  ///        deferred report, so use a string literal
+  /// @param function work to run every cycle
+  /// @param budget step execution times above this count as overruns
+  /// @return false if kMaxSteps steps have already been added
+  bool AddStep(const char * name,
+               std::function<void()> function,
+               std::chrono::nanoseconds budget = 0ns)
+  {
+    if (step_count_ >= kMaxSteps)
+    {
+      sjsu::LogError("Cannot add step %s, executive is full!", name);
+      return false;
+    }
+    Step & step   = steps_[step_count_++];
+    step.name     = name;
+    step.function = std::move(function);
+    step.budget   = budget;
+    return true;
+  }
+
+  /// Runs every step once, then waits until the next deadline. If the
+  /// deadline was already missed the schedule is moved forward to the next
+  /// period boundary instead of running back to back cycles to catch up.
+  void RunCycle()
+  {
+    std::chrono::nanoseconds start = uptime_();
+    if (cycle_count_ == 0)
+    {
+      next_deadline_ = start;
+    }
+    else
+    {
+      start_jitter_.Record(start - next_deadline_);
+    }
+
+    for (size_t i = 0; i < step_count_; i++)
+    {
+      Step & step                         = steps_[i];
+      std::chrono::nanoseconds step_start = uptime_();
+      step.function();
+      std::chrono::nanoseconds elapsed = uptime_() - step_start;
+      step.execution_time.Record(elapsed);
+      if (step.budget != 0ns && elapsed > step.budget)
+      {
+        step.overruns++;
+      }
+    }
+
+    std::chrono::nanoseconds end = uptime_();
+    cycle_time_.Record(end - start);
+    cycle_count_++;
+
+    next_deadline_ += period_;
+    if (end > next_deadline_)
+    {
+      overruns_++;
+      auto missed = static_cast<uint64_t>((end - next_deadline_) / period_);
+      missed_cycles_ += missed + 1;
+      next_deadline_ += period_ * static_cast<int64_t>(missed + 1);
+    }
+    std::chrono::nanoseconds remaining = next_deadline_ - uptime_();
+    if (remaining > 0ns)
+    {
+      delay_(remaining);
+    }
+  }
+
+  /// Runs cycles forever
+  [[noreturn]] void Run()
+  {
+    while (true)
+    {
+      RunCycle();
+    }
+  }
+
+  /// Logs the timing of every step and of the whole cycle
+  void PrintStatistics() const
+  {
+    sjsu::LogInfo("Period %lluus, %lu cycles, %lu overruns, %lu missed",
+                  static_cast<unsigned long long>(
+                      std::chrono::duration_cast<std::chrono::microseconds>(
+                          period_)
+                          .count()),
+                  static_cast<unsigned long>(cycle_count_),
+                  static_cast<unsigned long>(overruns_),
+                  static_cast<unsigned long>(missed_cycles_));
+    Print("cycle", cycle_time_, overruns_);
+    Print("jitter", start_jitter_, 0);
+    for (size_t i = 0; i < step_count_; i++)
+    {
+      Print(steps_[i].name, steps_[i].execution_time, steps_[i].overruns);
+    }
+  }
+
+  /// Records the same report as PrintStatistics() in the deferred log, for
+  /// callers that must not block on the UART. Leaves out the minimum and
+  /// mean to fit each line into a deferred log message.
+  void DeferStatistics() const
+  {
+    DeferLogInfo(
+        "Period %luus, %lu cycles, %lu overruns, %lu missed",
+        static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(period_)
+                .count()),
+        static_cast<uint32_t>(cycle_count_),
+        static_cast<uint32_t>(overruns_),
+        static_cast<uint32_t>(missed_cycles_));
+    DeferPrint("cycle", cycle_time_, overruns_);
+    DeferPrint("jitter", start_jitter_, 0);
+    for (size_t i = 0; i < step_count_; i++)
+    {
+      DeferPrint(steps_[i].name, steps_[i].execution_time, steps_[i].overruns);
+    }
+  }
+
+  /// Clears all statistics, i.e. after start up work is done
+  void ResetStatistics()
+  {
+    cycle_time_.Reset();
+    start_jitter_.Reset();
+    overruns_      = 0;
+    missed_cycles_ = 0;
+    for (size_t i = 0; i < step_count_; i++)
+    {
+      steps_[i].execution_time.Reset();
+      steps_[i].overruns = 0;
+    }
+  }
+
+  const Step & GetStep(size_t index) const
+  {
+    return steps_[index];
+  }
+
+  size_t GetStepCount() const
+  {
+    return step_count_;
+  }
+
+  /// @return time from the start to the end of each cycle's steps
+  const TimingStatistics & GetCycleTime() const
+  {
+    return cycle_time_;
+  }
+
+  /// @return how late each cycle started relative to its deadline
+  const TimingStatistics & GetStartJitter() const
+  {
+    return start_jitter_;
+  }
+
+  /// @return number of cycles whose steps took longer than the period
+  uint32_t GetOverruns() const
+  {
+    return overruns_;
+  }
+
+  /// @return number of deadlines skipped because of overruns
+  uint64_t GetMissedCycles() const
+  {
+    return missed_cycles_;
+  }
+
+  uint32_t GetCycleCount() const
+  {
+    return cycle_count_;
+  }
+
+ private:
+  static void Print(const char * name,
+                    const TimingStatistics & statistics,
+                    uint32_t overruns)
+  {
+    sjsu::LogInfo(
+        "%-12s min %5lluus mean %5lluus p50 %5lluus p99 %5lluus max %5lluus "
+        "overruns %lu",
+        name, static_cast<unsigned long long>(statistics.GetMin().count()),
+        static_cast<unsigned long long>(statistics.GetMean().count()),
+        static_cast<unsigned long long>(statistics.GetPercentile(50).count()),
+        static_cast<unsigned long long>(statistics.GetPercentile(99).count()),
+        static_cast<unsigned long long>(statistics.GetMax().count()),
+        static_cast<unsigned long>(overruns));
+  }
+
+  static void DeferPrint(const char * name,
+                         const TimingStatistics & statistics,
+                         uint32_t overruns)
+  {
+    DeferLogInfo(
+        "%-12s p50 %5luus p99 %5luus max %5luus overruns %lu", name,
+        static_cast<uint32_t>(statistics.GetPercentile(50).count()),
+        static_cast<uint32_t>(statistics.GetPercentile(99).count()),
+        static_cast<uint32_t>(statistics.GetMax().count()),
+        static_cast<uint32_t>(overruns));
+  }
+
+  std::chrono::nanoseconds period_;
+  UptimeFunction uptime_;
+  DelayFunction delay_;
+  std::array<Step, kMaxSteps> steps_;
+  size_t step_count_                      = 0;
+  std::chrono::nanoseconds next_deadline_ = 0ns;
+  TimingStatistics cycle_time_;
+  TimingStatistics start_jitter_;
+  uint32_t cycle_count_   = 0;
+  uint32_t overruns_      = 0;
+  uint64_t missed_cycles_ = 0;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace sjsu::common
+{
+/// RequestWriter builds text (HTTP request lines, headers and query strings)
+/// into a fixed size buffer without ever touching the heap. Writes that do
+/// not fit are dropped and the writer is flagged as overflowed, so callers
+/// must check HasOverflowed() before sending the contents anywhere.
+class RequestWriter
+{
+ public:
+  /// @param buffer storage the request is written into
+  explicit RequestWriter(std::span<char> buffer) : buffer_(buffer) {}
+
+  RequestWriter(const RequestWriter &) = delete;
+  RequestWriter & operator=(const RequestWriter &) = delete;
+
+  /// Empties the writer so a new request can be built
+  void Clear()
+  {
+    length_         = 0;
+    overflowed_     = false;
+    has_parameters_ = false;
+  }
+
+  /// Appends raw text
+  RequestWriter & Append(std::string_view text)
+  {
+    if (text.size() > buffer_.size() - length_)
+    {
+      overflowed_ = true;
+      return *this;
+    }
+    std::copy(text.begin(), text.end(), buffer_.begin() + length_);
+    length_ += text.size();
+    return *this;
+  }
+
+  /// Appends a single character
+  RequestWriter & Append(char character)
+  {
+    return Append(std::string_view(&character, 1));
+  }
+
+  /// Appends a signed integer in base 10
+  RequestWriter & AppendInteger(int32_t value)
+  {
+    if (value < 0)
+    {
+      Append('-');
+      // Widen before negating so INT32_MIN does not overflow
+      int64_t magnitude = -static_cast<int64_t>(value);
+      return AppendUnsigned(static_cast<uint32_t>(magnitude));
+    }
+    return AppendUnsigned(static_cast<uint32_t>(value));
+  }
+
+  /// Appends an unsigned integer in base 10, zero padded to min_digits
+  RequestWriter & AppendUnsigned(uint32_t value, uint8_t min_digits = 1)
+  {
+    // 4294967295 is the longest value, 10 digits
+    std::array<char, 10> digits;
+    size_t count = 0;
+    do
+    {
+      digits[count++] = static_cast<char>('0' + (value % 10));
+      value /= 10;
+    } while (value != 0 && count < digits.size());
+
+    while (count < min_digits && count < digits.size())
+    {
+      digits[count++] = '0';
+    }
+
+    std::array<char, 10> reversed;
+    for (size_t i = 0; i < count; i++)
+    {
+      reversed[i] = digits[count - 1 - i];
+    }
+    return Append(std::string_view(reversed.data(), count));
+  }
+
+  /// Appends a number with a fixed number of decimal places (i.e. 12.30)
+  /// using integer arithmetic only, so no printf float support is needed.
+  /// @param value the number to write
+  /// @param decimals digits after the decimal point, 0 to 6
+  RequestWriter & AppendFixed(float value, uint8_t decimals = 2)
+  {
+    constexpr std::array<uint32_t, 7> kPowersOfTen = {
+      1, 10, 100, 1'000, 10'000, 100'000, 1'000'000
+    };
+    if (value != value)
+    {
+      return Append("nan");
+    }
+
+    decimals       = std::min<uint8_t>(decimals, kPowersOfTen.size() - 1);
+    uint32_t scale = kPowersOfTen[decimals];
+    bool negative  = value < 0.0f;
+    float scaled   = (negative ? -value : value) * static_cast<float>(scale);
+    // Saturate rather than wrap on values too large for the buffer format
+    uint32_t fixed = (scaled >= 4'294'967'040.0f)
+                         ? UINT32_MAX
+                         : static_cast<uint32_t>(scaled + 0.5f);
+
+    if (negative && fixed != 0)
+    {
+      Append('-');
+    }
+    AppendUnsigned(fixed / scale);
+    if (decimals > 0)
+    {
+      Append('.');
+      AppendUnsigned(fixed % scale, decimals);
+    }
+    return *this;
+  }
+
+  /// Appends the separator and name of a query parameter. The first
+  /// parameter is prefixed with '?' and the rest with '&'.
+  RequestWriter & AppendParameterName(std::string_view name)
+  {
+    Append(has_parameters_ ? '&' : '?');
+    has_parameters_ = true;
+    return Append(name).Append('=');
+  }
+
+  /// Appends a query parameter i.e. ?name=value or &name=value
+  template <std::integral Integer>
+  requires(!std::same_as<Integer, char>)
+  RequestWriter & AppendParameter(std::string_view name, Integer value)
+  {
+    return AppendParameterName(name).AppendInteger(
+        static_cast<int32_t>(value));
+  }
+
+  /// Appends a single character query parameter
+  RequestWriter & AppendParameter(std::string_view name, char value)
+  {
+    return AppendParameterName(name).Append(value);
+  }
+
+  /// Appends a fixed precision query parameter
+  template <std::floating_point Number>
+  RequestWriter & AppendParameter(std::string_view name,
+                                  Number value,
+                                  uint8_t decimals = 2)
+  {
+    return AppendParameterName(name).AppendFixed(static_cast<float>(value),
+                                                 decimals);
+  }
+
+  /// @return true if any write did not fit in the buffer
+  bool HasOverflowed() const
+  {
+    return overflowed_;
+  }
+
+  /// @return the text written so far
+  std::string_view GetView() const
+  {
+    return std::string_view(buffer_.data(), length_);
+  }
+
+  /// @return the text written so far as bytes, ready to be sent on a socket
+  std::span<const uint8_t> GetBytes() const
+  {
+    return std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t *>(buffer_.data()), length_);
+  }
+
+  size_t GetLength() const
+  {
+    return length_;
+  }
+
+  size_t GetCapacity() const
+  {
+    return buffer_.size();
+  }
+
+ private:
+  std::span<char> buffer_;
+  size_t length_       = 0;
+  bool overflowed_     = false;
+  bool has_parameters_ = false;
+};
+
+/// Holds the storage for StaticRequestWriter. Inherited before RequestWriter
+/// so the buffer exists before the writer is handed a view of it.
+template <size_t kCapacity>
+struct RequestWriterStorage
+{
+  std::array<char, kCapacity> storage_;
+};
+
+/// RequestWriter that owns a buffer of kCapacity bytes
+template <size_t kCapacity>
+class StaticRequestWriter : private RequestWriterStorage<kCapacity>,
+                            public RequestWriter
+{
+ public:
+  StaticRequestWriter()
+      : RequestWriterStorage<kCapacity>(),
+        RequestWriter(RequestWriterStorage<kCapacity>::storage_)
+  {
+  }
+};
+}  // namespace sjsu::common
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+#include "peripherals/uart.hpp"
+#include "utility/time/time.hpp"
+#include "byte_ring.hpp"
+#include "task_delay.hpp"
+
+namespace sjsu::common
+{
+/// RingUart receives through a ByteRing filled in the background, so bytes
+/// arriving while the reading task is busy or asleep are kept instead of
+/// overrunning the UART's hardware FIFO. It wraps the hardware UART and can
+/// be handed to any driver that takes an sjsu::Uart, i.e. sjsu::Esp8266.
+///
+/// The ring is filled by OnReceiveInterrupt(), called from the UART's receive
+/// interrupt, or by Receive(), called from a DMA completion handler. Writes
+/// go straight to the hardware UART.
+///
+/// Drivers poll HasData() while waiting for a response. With an idle wait,
+/// HasData() sleeps for that long whenever the ring is empty so lower
+/// priority tasks get the CPU instead of the polling loop.
+template <size_t kCapacity>
+class RingUart : public sjsu::Uart
+{
+ public:
+  using CallbackFunction = void (*)();
+  using DelayFunction    = void (*)(std::chrono::nanoseconds);
+
+  /// Bytes drained from the hardware per read, the FIFO depth of most UARTs
+  static constexpr size_t kFifoSize = 16;
+
+  /// @param uart hardware UART the ring is filled from
+  /// @param enable_receive_interrupt called after the hardware UART is
+  ///        initialized to route its receive interrupt to
+  ///        OnReceiveInterrupt(), nullptr if Receive() is fed some other way
+  /// @param idle_wait time HasData() sleeps while the ring is empty, 0 to
+  ///        return right away
+  /// @param delay used to sleep, blocks the task while the scheduler runs
+  explicit RingUart(sjsu::Uart & uart,
+                    CallbackFunction enable_receive_interrupt = nullptr,
+                    std::chrono::nanoseconds idle_wait        = 0ns,
+                    DelayFunction delay                       = TaskDelay)
+      : uart_(uart),
+        enable_receive_interrupt_(enable_receive_interrupt),
+        idle_wait_(idle_wait),
+        delay_(delay)
+  {
+  }
+
+  void ModuleInitialize() override
+  {
+    uart_.settings = settings;
+    uart_.Initialize();
+    if (enable_receive_interrupt_)
+    {
+      enable_receive_interrupt_();
+    }
+  }
+
+  void Write(std::span<const uint8_t> data) override
+  {
+    uart_.Write(data);
+  }
+
+  size_t Read(std::span<uint8_t> data) override
+  {
+    return ring_.Pop(data);
+  }
+
+  size_t HasData() override
+  {
+    size_t size = ring_.Size();
+    if (size == 0 && idle_wait_ > 0ns)
+    {
+      delay_(idle_wait_);
+      size = ring_.Size();
+    }
+    return size;
+  }
+
+  /// Moves every byte waiting in the hardware FIFO into the ring. Call from
+  /// the UART's receive interrupt.
+  void OnReceiveInterrupt()
+  {
+    std::array<uint8_t, kFifoSize> fifo;
+    size_t count;
+    while ((count = uart_.Read(fifo)) > 0)
+    {
+      ring_.Push(std::span<const uint8_t>(fifo.data(), count));
+    }
+  }
+
+  /// Queues bytes received some other way, i.e. by DMA. Must only be called
+  /// from one context, like OnReceiveInterrupt().
+  /// @return number of bytes queued, the rest were dropped
+  size_t Receive(std::span<const uint8_t> data)
+  {
+    return ring_.Push(data);
+  }
+
+  /// @return the ring, for its peak size and dropped byte count
+  const ByteRing<kCapacity> & GetRing() const
+  {
+    return ring_;
+  }
+
+ private:
+  sjsu::Uart & uart_;
+  CallbackFunction enable_receive_interrupt_;
+  std::chrono::nanoseconds idle_wait_;
+  DelayFunction delay_;
+  ByteRing<kCapacity> ring_;
+};
+}  // namespace sjsu::common
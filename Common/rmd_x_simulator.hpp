@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "peripherals/lpc40xx/can.hpp"
+#include "utility/time/time.hpp"
+
+namespace sjsu::common
+{
+/// RmdXSimulator stands in for a CAN bus of RMD-X motors in host tests. It
+/// decodes the frames sjsu::RmdX and MotorGroup send, moves each simulated
+/// motor with simple rigid body dynamics and answers like the real motors
+/// do, so MotorFeedbackCache sees realistic speeds, currents and angles.
+///
+/// Time only moves in Step(), so a scenario covering minutes of driving runs
+/// in milliseconds. Hook it up in place of the mock CAN peripheral:
+///
+///     When(OverloadedMethod(mock_can, Can::Send,
+///                           void(const Can::Message_t &)))
+///         .AlwaysDo([&](const Can::Message_t & m) { simulator.Send(m); });
+///     When(Method(mock_can, Can::HasData))
+///         .AlwaysDo([&]() { return simulator.HasData(); });
+///     When(Method(mock_can, Can::Receive))
+///         .AlwaysDo([&]() { return simulator.Receive(); });
+///
+/// Modeled: speed and position control with an acceleration limit (rotor and
+/// load inertia), a speed limit, torque current from acceleration and
+/// friction, and the multi-turn angle. Not modeled: electrical dynamics,
+/// temperature rise and bus timing (replies are queued immediately).
+template <size_t kMotorCount>
+class RmdXSimulator
+{
+ public:
+  static constexpr uint32_t kMultiMotorId        = 0x280;
+  static constexpr uint8_t kReadMultiTurnCommand = 0x92;
+  static constexpr uint8_t kReadStatus2Command   = 0x9C;
+  static constexpr uint8_t kSpeedCommand         = 0xA2;
+  static constexpr uint8_t kPositionCommand      = 0xA4;
+  static constexpr size_t kReplyCapacity         = 64;
+  /// Torque current range of +/-2048 maps to +/-33A
+  static constexpr float kCurrentUnitsPerAmp = 2048.0f / 33.0f;
+
+  /// Physical limits of one motor, at the motor shaft (before the gear)
+  struct Parameters_t
+  {
+    /// RMD-X8 rated speed
+    float max_speed = 3000.0f;  // degrees per second
+    /// Limited by rotor and load inertia
+    float max_acceleration = 36000.0f;  // degrees per second^2
+    /// Torque current needed per degree per second^2 of acceleration
+    float amps_per_acceleration = 1.0f / 6000.0f;
+    /// Current needed to overcome friction while turning
+    float friction_amps = 0.5f;
+    float temperature   = 30.0f;  // celsius
+  };
+
+  /// State of one motor at the motor shaft
+  struct Motor_t
+  {
+    uint32_t id = 0;
+    Parameters_t parameters;
+    float angle        = 0.0f;  // degrees, multi-turn
+    float speed        = 0.0f;  // degrees per second
+    float acceleration = 0.0f;  // degrees per second^2
+    /// Position control is active, otherwise speed control
+    bool is_positioning = false;
+    float target_speed  = 0.0f;
+    float target_angle  = 0.0f;
+    /// Speed limit of the current position command
+    float position_speed = 0.0f;
+    uint32_t commands    = 0;
+  };
+
+  /// @param ids CAN ids of the simulated motors, i.e. 0x141
+  /// @param parameters limits shared by all motors, adjust per motor with
+  ///        GetMotor()
+  explicit RmdXSimulator(const std::array<uint32_t, kMotorCount> & ids,
+                         const Parameters_t & parameters = {})
+  {
+    for (size_t i = 0; i < kMotorCount; i++)
+    {
+      motors_[i].id         = ids[i];
+      motors_[i].parameters = parameters;
+    }
+  }
+
+  /// Decodes a frame sent on the bus, as if every motor received it.
+  /// Frames to other ids and unknown commands are ignored.
+  void Send(const sjsu::Can::Message_t & message)
+  {
+    for (Motor_t & motor : motors_)
+    {
+      if (message.id == motor.id || message.id == kMultiMotorId)
+      {
+        Execute(motor, message.payload);
+      }
+    }
+  }
+
+  /// @return true if a reply is waiting to be received
+  bool HasData() const
+  {
+    return reply_count_ != 0;
+  }
+
+  /// @return the oldest unread reply, an empty message if there is none
+  sjsu::Can::Message_t Receive()
+  {
+    if (reply_count_ == 0)
+    {
+      return {};
+    }
+    sjsu::Can::Message_t reply = replies_[reply_head_];
+    reply_head_                = (reply_head_ + 1) % kReplyCapacity;
+    reply_count_--;
+    return reply;
+  }
+
+  /// Advances every motor by a time step. Steps of 1ms or less keep the
+  /// position control from overshooting.
+  void Step(std::chrono::nanoseconds duration)
+  {
+    float dt = std::chrono::duration<float>(duration).count();
+    if (dt <= 0.0f)
+    {
+      return;
+    }
+    for (Motor_t & motor : motors_)
+    {
+      StepMotor(motor, dt);
+    }
+    elapsed_ += duration;
+  }
+
+  /// Steps in increments of at most period until duration has passed
+  void Run(std::chrono::nanoseconds duration,
+           std::chrono::nanoseconds period = 1ms)
+  {
+    while (duration > 0ns)
+    {
+      std::chrono::nanoseconds step = std::min(duration, period);
+      Step(step);
+      duration -= step;
+    }
+  }
+
+  /// @param id CAN id of the motor
+  /// @return the simulated motor, nullptr if there is no motor with the id
+  Motor_t * GetMotor(uint32_t id)
+  {
+    for (Motor_t & motor : motors_)
+    {
+      if (motor.id == id)
+      {
+        return &motor;
+      }
+    }
+    return nullptr;
+  }
+
+  /// @return simulated time since construction
+  std::chrono::nanoseconds GetElapsedTime() const
+  {
+    return elapsed_;
+  }
+
+  /// @return replies that did not fit in the queue because nothing read them
+  uint32_t GetDroppedReplies() const
+  {
+    return dropped_replies_;
+  }
+
+ private:
+  static int32_t ReadInt32(const std::array<uint8_t, 8> & data, size_t start)
+  {
+    return static_cast<int32_t>(
+        static_cast<uint32_t>(data[start]) |
+        (static_cast<uint32_t>(data[start + 1]) << 8) |
+        (static_cast<uint32_t>(data[start + 2]) << 16) |
+        (static_cast<uint32_t>(data[start + 3]) << 24));
+  }
+
+  void Execute(Motor_t & motor, const std::array<uint8_t, 8> & data)
+  {
+    switch (data[0])
+    {
+      case kSpeedCommand:
+        // 0.01 degrees per second
+        motor.target_speed   = static_cast<float>(ReadInt32(data, 4)) / 100.0f;
+        motor.is_positioning = false;
+        QueueStatus(motor, data[0]);
+        break;
+      case kPositionCommand:
+        // Speed limit in degrees per second, angle in 0.01 degrees
+        motor.position_speed =
+            static_cast<float>(static_cast<uint16_t>(data[2] | (data[3] << 8)));
+        motor.target_angle   = static_cast<float>(ReadInt32(data, 4)) / 100.0f;
+        motor.is_positioning = true;
+        QueueStatus(motor, data[0]);
+        break;
+      case kReadStatus2Command: QueueStatus(motor, data[0]); break;
+      case kReadMultiTurnCommand: QueueAngle(motor); break;
+      default: return;
+    }
+    motor.commands++;
+  }
+
+  void StepMotor(Motor_t & motor, float dt)
+  {
+    const Parameters_t & parameters = motor.parameters;
+    float desired_speed              = motor.target_speed;
+    if (motor.is_positioning)
+    {
+      // Fastest speed that can still stop at the target angle, allowing for
+      // one more step at that speed
+      float error    = motor.target_angle - motor.angle;
+      float step     = parameters.max_acceleration * dt;
+      float braking  = 2.0f * parameters.max_acceleration * std::fabs(error);
+      float stopping = std::sqrt(step * step + braking) - step;
+      float limit    = (motor.position_speed > 0.0f)
+                           ? std::min(motor.position_speed, stopping)
+                           : stopping;
+      desired_speed  = std::copysign(limit, error);
+    }
+    desired_speed = std::clamp(desired_speed, -parameters.max_speed,
+                               parameters.max_speed);
+
+    float max_change = parameters.max_acceleration * dt;
+    float change =
+        std::clamp(desired_speed - motor.speed, -max_change, max_change);
+    float previous_speed = motor.speed;
+    motor.speed += change;
+    motor.acceleration = change / dt;
+    motor.angle += (previous_speed + motor.speed) / 2.0f * dt;
+
+    // Settle exactly on the target instead of dithering around it
+    if (motor.is_positioning &&
+        std::fabs(motor.target_angle - motor.angle) <= std::fabs(change * dt) &&
+        std::fabs(motor.speed) <= max_change)
+    {
+      motor.angle = motor.target_angle;
+      motor.speed = 0.0f;
+    }
+  }
+
+  float GetCurrent(const Motor_t & motor) const
+  {
+    const Parameters_t & parameters = motor.parameters;
+    float amps = motor.acceleration * parameters.amps_per_acceleration;
+    if (motor.speed != 0.0f)
+    {
+      amps += std::copysign(parameters.friction_amps, motor.speed);
+    }
+    return amps;
+  }
+
+  /// Temperature, torque current, speed and encoder position
+  void QueueStatus(const Motor_t & motor, uint8_t command)
+  {
+    auto temperature = static_cast<int8_t>(motor.parameters.temperature);
+    auto current     = static_cast<int16_t>(std::clamp(
+        GetCurrent(motor) * kCurrentUnitsPerAmp, -2048.0f, 2048.0f));
+    auto speed       = static_cast<int16_t>(
+        std::clamp(motor.speed, -32768.0f, 32767.0f));
+    // 16 bit single turn encoder
+    float turn       = std::fmod(motor.angle, 360.0f);
+    auto encoder     = static_cast<uint16_t>(
+        ((turn < 0.0f) ? turn + 360.0f : turn) / 360.0f * 65535.0f);
+
+    sjsu::Can::Message_t reply = NewReply(motor);
+    reply.payload = { command,
+                      static_cast<uint8_t>(temperature),
+                      static_cast<uint8_t>(current & 0xFF),
+                      static_cast<uint8_t>((current >> 8) & 0xFF),
+                      static_cast<uint8_t>(speed & 0xFF),
+                      static_cast<uint8_t>((speed >> 8) & 0xFF),
+                      static_cast<uint8_t>(encoder & 0xFF),
+                      static_cast<uint8_t>(encoder >> 8) };
+    QueueReply(reply);
+  }
+
+  /// 56 bit signed multi-turn angle in 0.01 degrees
+  void QueueAngle(const Motor_t & motor)
+  {
+    auto angle = static_cast<int64_t>(std::lround(motor.angle * 100.0f));
+    sjsu::Can::Message_t reply = NewReply(motor);
+    reply.payload[0]           = kReadMultiTurnCommand;
+    for (size_t i = 1; i < reply.payload.size(); i++)
+    {
+      reply.payload[i] = static_cast<uint8_t>(angle >> (8 * (i - 1)));
+    }
+    QueueReply(reply);
+  }
+
+  static sjsu::Can::Message_t NewReply(const Motor_t & motor)
+  {
+    sjsu::Can::Message_t reply;
+    reply.id                = motor.id;
+    reply.format            = sjsu::Can::Message_t::Format::kStandard;
+    reply.is_remote_request = false;
+    reply.length            = 8;
+    reply.payload           = {};
+    return reply;
+  }
+
+  void QueueReply(const sjsu::Can::Message_t & reply)
+  {
+    if (reply_count_ == kReplyCapacity)
+    {
+      dropped_replies_++;
+      return;
+    }
+    replies_[(reply_head_ + reply_count_) % kReplyCapacity] = reply;
+    reply_count_++;
+  }
+
+  std::array<Motor_t, kMotorCount> motors_;
+  std::array<sjsu::Can::Message_t, kReplyCapacity> replies_;
+  size_t reply_head_                = 0;
+  size_t reply_count_               = 0;
+  uint32_t dropped_replies_         = 0;
+  std::chrono::nanoseconds elapsed_ = 0ns;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+
+#include "utility/log.hpp"
+
+namespace sjsu::common
+{
+/// Outcome of an operation on the control and network paths. These return a
+/// Status instead of throwing, so the Drive and Arm code also builds with
+/// -fno-exceptions, where every failure must be reported this way.
+enum class Status : uint8_t
+{
+  kOk = 0,
+  /// Mission control asked for a drive mode that does not exist
+  kInvalidMode,
+  /// The wheels did not reach the new mode's angles in time
+  kModeTimeout,
+  /// A wheel or joint did not find its home mark
+  kHomingFailed,
+  /// The server did not answer, the connection was dropped
+  kNoResponse,
+  /// The server answered with an error or an incomplete response
+  kBadResponse,
+  /// SJSU-Dev2 threw, only returned by Guard() when exceptions are enabled
+  kException,
+};
+
+/// @return name of the status for logs, i.e. "mode timeout"
+constexpr const char * ToString(Status status)
+{
+  switch (status)
+  {
+    case Status::kOk: return "ok";
+    case Status::kInvalidMode: return "invalid mode";
+    case Status::kModeTimeout: return "mode timeout";
+    case Status::kHomingFailed: return "homing failed";
+    case Status::kNoResponse: return "no response";
+    case Status::kBadResponse: return "bad response";
+    case Status::kException: return "exception";
+  }
+  return "unknown";
+}
+
+/// Runs a function at a task boundary. With exceptions enabled, an exception
+/// escaping it (i.e. from an SJSU-Dev2 driver) is caught here and returned as
+/// Status::kException after logging what it was. Without them this is just
+/// a call, so callers handle failures the same way in both builds.
+/// @param function returns a Status
+template <typename Function>
+Status Guard(Function function)
+{
+#if defined(__cpp_exceptions)
+  try
+  {
+    return function();
+  }
+  catch (const std::exception & e)
+  {
+    sjsu::LogError("Exception: %s", e.what());
+    return Status::kException;
+  }
+#else
+  return function();
+#endif
+}
+}  // namespace sjsu::common
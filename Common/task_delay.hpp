@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+
+#include "utility/rtos.hpp"
+#include "utility/time/time.hpp"
+
+namespace sjsu::common
+{
+/// Waits for a duration without holding on to the CPU. Once the scheduler is
+/// running, the calling task is blocked for the whole ticks of the duration
+/// so lower priority tasks run, and only the part shorter than a tick is
+/// busy waited to keep deadlines precise. Before the scheduler starts this
+/// is sjsu::Delay().
+inline void TaskDelay(std::chrono::nanoseconds duration)
+{
+  if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+  {
+    sjsu::Delay(duration);
+    return;
+  }
+
+  constexpr std::chrono::nanoseconds kTickPeriod =
+      std::chrono::nanoseconds(std::chrono::seconds(1)) / configTICK_RATE_HZ;
+  std::chrono::nanoseconds end = sjsu::Uptime() + duration;
+  // vTaskDelay(n) returns at the n-th tick interrupt, within n ticks
+  auto ticks = static_cast<TickType_t>(duration / kTickPeriod);
+  if (ticks > 0)
+  {
+    vTaskDelay(ticks);
+  }
+  std::chrono::nanoseconds remaining = end - sjsu::Uptime();
+  if (remaining > std::chrono::nanoseconds(0))
+  {
+    sjsu::Delay(remaining);
+  }
+}
+}  // namespace sjsu::common
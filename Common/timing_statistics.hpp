@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace sjsu::common
+{
+/// TimingStatistics accumulates durations (execution times, period jitter)
+/// in constant time and memory: min, max, mean and a log-linear histogram
+/// for percentiles. Each histogram bucket is at most 25% wide, which is
+/// plenty to tell whether a control period is being met.
+class TimingStatistics
+{
+ public:
+  /// Durations are stored in microseconds. Buckets cover 0us to ~4295s.
+  static constexpr int kSubBucketBits = 2;
+  static constexpr int kSubBuckets    = 1 << kSubBucketBits;
+  static constexpr int kOctaves       = 32 - kSubBucketBits + 1;
+  static constexpr int kBuckets       = kOctaves * kSubBuckets;
+
+  /// Adds one sample
+  void Record(std::chrono::nanoseconds duration)
+  {
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::max(duration, std::chrono::nanoseconds(0)));
+    uint32_t sample   = static_cast<uint32_t>(std::min<int64_t>(
+        microseconds.count(), static_cast<int64_t>(UINT32_MAX)));
+
+    if (count_ == 0 || sample < min_)
+    {
+      min_ = sample;
+    }
+    max_ = std::max(max_, sample);
+    sum_ += sample;
+    count_++;
+    histogram_[BucketOf(sample)]++;
+  }
+
+  /// Forgets all samples
+  void Reset()
+  {
+    *this = TimingStatistics();
+  }
+
+  uint32_t GetCount() const
+  {
+    return count_;
+  }
+
+  std::chrono::microseconds GetMin() const
+  {
+    return std::chrono::microseconds(min_);
+  }
+
+  std::chrono::microseconds GetMax() const
+  {
+    return std::chrono::microseconds(max_);
+  }
+
+  std::chrono::microseconds GetMean() const
+  {
+    return std::chrono::microseconds((count_ == 0) ? 0 : sum_ / count_);
+  }
+
+  /// @param percent 0 to 100, i.e. 99 for the 99th percentile
+  /// @return upper bound of the bucket holding the percentile, never more
+  ///         than the largest sample
+  std::chrono::microseconds GetPercentile(float percent) const
+  {
+    if (count_ == 0)
+    {
+      return std::chrono::microseconds(0);
+    }
+    uint32_t rank = static_cast<uint32_t>(
+        static_cast<float>(count_) * std::clamp(percent, 0.0f, 100.0f) /
+        100.0f);
+    rank         = std::clamp<uint32_t>(rank, 1, count_);
+    uint32_t seen = 0;
+    for (int bucket = 0; bucket < kBuckets; bucket++)
+    {
+      seen += histogram_[bucket];
+      if (seen >= rank)
+      {
+        return std::chrono::microseconds(
+            std::min(BucketUpperBound(bucket), max_));
+      }
+    }
+    return GetMax();
+  }
+
+ private:
+  /// Values below kSubBuckets get a bucket each, above that each power of two
+  /// is split into kSubBuckets equal parts.
+  static int BucketOf(uint32_t value)
+  {
+    if (value < kSubBuckets)
+    {
+      return static_cast<int>(value);
+    }
+    int magnitude = 31 - std::countl_zero(value);
+    int shift     = magnitude - kSubBucketBits;
+    int sub       = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + sub;
+  }
+
+  static uint32_t BucketUpperBound(int bucket)
+  {
+    if (bucket < kSubBuckets)
+    {
+      return static_cast<uint32_t>(bucket);
+    }
+    int shift      = bucket / kSubBuckets - 1;
+    uint64_t sub   = static_cast<uint64_t>(bucket % kSubBuckets);
+    uint64_t lower = (kSubBuckets + sub) << shift;
+    return static_cast<uint32_t>(
+        std::min<uint64_t>(lower + (uint64_t{ 1 } << shift) - 1, UINT32_MAX));
+  }
+
+  std::array<uint32_t, kBuckets> histogram_ = {};
+  uint64_t sum_                             = 0;
+  uint32_t count_                           = 0;
+  uint32_t min_                             = 0;
+  uint32_t max_                             = 0;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,266 @@
+// Load generator for the mission control server. Replays many rover clients
+// at once, each exchanging requests over its own keep-alive connection
+// through the same Esp request and parse path as the firmware, and reports
+// the round-trip latency percentiles and throughput. Given a path, the
+// results are also written as JSON so runs can be compared by a script.
+//
+//   ./build/mission_control_server &
+//   ./build/mission_control_load [-h host] [-p port] [-c clients]
+//                                [-n requests] [-e drive|arm|mixed|rover]
+//                                [results.json]
+//
+// Clients in rover mode send the drive and arm telemetry in one batched
+// request through MissionControlExchange, like a board running both.
+//
+// Needs SJSU-Dev2 for the Esp dependencies, see makefile.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../esp.hpp"
+#include "../host_socket.hpp"
+#include "../json_reader.hpp"
+#include "../mission_control_exchange.hpp"
+#include "../../Arm/arm_client.hpp"
+#include "../../Drive/drive_client.hpp"
+#include "../../Drive/mission_control_data.hpp"
+#include "../../Drive/rover_drive_system.hpp"
+
+namespace
+{
+enum class Client
+{
+  kDrive,
+  kArm,
+  kRover,
+};
+
+struct Options_t
+{
+  const char * host   = "localhost";
+  uint16_t port       = 8080;
+  int clients         = 8;
+  int requests        = 1000;
+  const char * mix    = "drive";
+  const char * output = nullptr;
+};
+
+/// Round trips of one client
+struct ClientResult_t
+{
+  std::vector<double> latencies;  // microseconds
+  int failures = 0;
+};
+
+/// Sends one drive request with the telemetry the rover would report
+bool ExchangeDrive(sjsu::common::Esp & esp, std::span<char> response_body)
+{
+  sjsu::drive::protocol::DriveTelemetry telemetry;
+  sjsu::drive::RoverDriveSystem::WriteRequestParameters(esp.NewGETRequest(),
+                                                        telemetry);
+  std::string_view response = esp.SendGETRequest(response_body);
+  sjsu::drive::MissionControlData data;
+  return sjsu::drive::ParseMissionControlData(response, data) ==
+         sjsu::drive::kAllFields;
+}
+
+/// Sends one arm request, valid if the response has any fields
+bool ExchangeArm(sjsu::common::Esp & esp, std::span<char> response_body)
+{
+  esp.NewGETRequest().Append("arm").AppendParameter("is_operational", 1);
+  std::string_view response = esp.SendGETRequest(response_body);
+  sjsu::common::JsonReader reader(response);
+  int fields = 0;
+  while (reader.Next())
+  {
+    fields++;
+  }
+  return fields > 0;
+}
+
+void RunClient(const Options_t & options,
+               Client client,
+               ClientResult_t & result)
+{
+  sjsu::common::HostWiFi wifi;
+  sjsu::common::HostSocket socket;
+  sjsu::common::Esp esp(wifi, socket, options.host, options.port);
+  std::array<char, 1024> response_body;
+  esp.Initialize();
+  esp.MaintainLink();
+
+  // Batched clients keep their exchange across requests like the firmware
+  sjsu::drive::CommandMailbox drive_commands;
+  sjsu::drive::TelemetryMailbox drive_telemetry;
+  sjsu::drive::DriveClient drive_client(drive_commands, drive_telemetry);
+  sjsu::arm::ArmCommandMailbox arm_commands;
+  sjsu::arm::ArmTelemetryMailbox arm_telemetry;
+  sjsu::arm::ArmClient arm_client(arm_commands, arm_telemetry);
+  sjsu::common::MissionControlExchange exchange(esp);
+  exchange.AddClient(drive_client);
+  exchange.AddClient(arm_client);
+
+  result.latencies.reserve(options.requests);
+  for (int i = 0; i < options.requests; i++)
+  {
+    auto start    = std::chrono::steady_clock::now();
+    bool is_valid = false;
+    switch (client)
+    {
+      case Client::kDrive:
+        is_valid = ExchangeDrive(esp, response_body);
+        break;
+      case Client::kArm: is_valid = ExchangeArm(esp, response_body); break;
+      case Client::kRover:
+        is_valid = exchange.Exchange() == sjsu::common::Status::kOk;
+        break;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (!is_valid)
+    {
+      result.failures++;
+      continue;
+    }
+    result.latencies.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+}
+
+double Percentile(const std::vector<double> & sorted, double percentile)
+{
+  if (sorted.empty())
+  {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1));
+  return sorted[index];
+}
+
+bool ParseOptions(int argc, char * argv[], Options_t & options)
+{
+  int option;
+  while ((option = getopt(argc, argv, "h:p:c:n:e:")) != -1)
+  {
+    switch (option)
+    {
+      case 'h': options.host = optarg; break;
+      case 'p': options.port = static_cast<uint16_t>(atoi(optarg)); break;
+      case 'c': options.clients = atoi(optarg); break;
+      case 'n': options.requests = atoi(optarg); break;
+      case 'e': options.mix = optarg; break;
+      default: return false;
+    }
+  }
+  if (optind < argc)
+  {
+    options.output = argv[optind];
+  }
+  std::string_view mix = options.mix;
+  return options.clients > 0 && options.requests > 0 &&
+         (mix == "drive" || mix == "arm" || mix == "mixed" || mix == "rover");
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  Options_t options;
+  if (!ParseOptions(argc, argv, options))
+  {
+    fprintf(stderr,
+            "usage: %s [-h host] [-p port] [-c clients] [-n requests] "
+            "[-e drive|arm|mixed|rover] [results.json]\n",
+            argv[0]);
+    return 1;
+  }
+
+  // Esp logs every request, which would measure the terminal instead
+  fflush(stdout);
+  int saved_stdout = dup(STDOUT_FILENO);
+  int null_output  = open("/dev/null", O_WRONLY);
+  dup2(null_output, STDOUT_FILENO);
+
+  std::vector<ClientResult_t> results(options.clients);
+  std::vector<std::thread> threads;
+  std::string_view mix = options.mix;
+  auto start           = std::chrono::steady_clock::now();
+  for (int i = 0; i < options.clients; i++)
+  {
+    Client client = Client::kDrive;
+    if (mix == "arm" || (mix == "mixed" && i % 2 == 1))
+    {
+      client = Client::kArm;
+    }
+    else if (mix == "rover")
+    {
+      client = Client::kRover;
+    }
+    threads.emplace_back(RunClient, std::cref(options), client,
+                         std::ref(results[i]));
+  }
+  for (std::thread & thread : threads)
+  {
+    thread.join();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  fflush(stdout);
+  dup2(saved_stdout, STDOUT_FILENO);
+  close(null_output);
+  close(saved_stdout);
+
+  std::vector<double> latencies;
+  int failures = 0;
+  for (const ClientResult_t & result : results)
+  {
+    latencies.insert(latencies.end(), result.latencies.begin(),
+                     result.latencies.end());
+    failures += result.failures;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  double throughput = latencies.size() / seconds;
+
+  printf("%d %s client(s) x %d requests to %s:%u in %.2fs\n",
+         options.clients, options.mix, options.requests, options.host,
+         static_cast<unsigned>(options.port), seconds);
+  printf("  %zu ok, %d failed, %.0f requests/s\n", latencies.size(), failures,
+         throughput);
+  printf("  round trip us: p50 %.0f, p90 %.0f, p99 %.0f, p99.9 %.0f, "
+         "max %.0f\n",
+         Percentile(latencies, 50), Percentile(latencies, 90),
+         Percentile(latencies, 99), Percentile(latencies, 99.9),
+         Percentile(latencies, 100));
+
+  if (options.output != nullptr)
+  {
+    FILE * file = fopen(options.output, "w");
+    if (file == nullptr)
+    {
+      fprintf(stderr, "Cannot write %s\n", options.output);
+      return 1;
+    }
+    fprintf(file,
+            "{\"benchmark\":\"mission_control_load\",\"clients\":%d,"
+            "\"mix\":\"%s\",\"requests\":%zu,\"failures\":%d,"
+            "\"requests_per_second\":%.1f,\"p50_us\":%.1f,\"p90_us\":%.1f,"
+            "\"p99_us\":%.1f,\"p999_us\":%.1f,\"max_us\":%.1f}\n",
+            options.clients, options.mix, latencies.size(), failures,
+            throughput, Percentile(latencies, 50), Percentile(latencies, 90),
+            Percentile(latencies, 99), Percentile(latencies, 99.9),
+            Percentile(latencies, 100));
+    fclose(file);
+  }
+  return failures == 0 ? 0 : 1;
+}
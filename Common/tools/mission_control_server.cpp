@@ -0,0 +1,491 @@
+// Local stand-in for the mission control server. Serves the drive and arm
+// endpoints over HTTP/1.1 keep-alive connections like the real server, with
+// the commands following a script, so the rover firmware, Esp on a host or
+// mission_control_load can be run without the internet.
+//
+//   ./build/mission_control_server [-p port] [-s script]
+//
+// A script has one command per line: the time in seconds since the server
+// started, the endpoint and the JSON body served from then on, i.e.
+//
+//   0   drive {"is_operational": 1, "drive_mode": "S", "speed": 0, "angle": 0}
+//   2.5 drive {"is_operational": 1, "drive_mode": "D", "speed": 20, "angle": 0}
+//
+// Lines starting with # are comments. Requests are matched to endpoints by
+// the last segment of their path, so /Vishnu-Adda/json-robo-test/drive?...
+// is served by "drive". Without a script, kDefaultScript is served.
+//
+// Requests to "rover" are answered for several endpoints at once, one object
+// per subsystem parameter of the query, i.e. rover?subsystem=drive&...
+// &subsystem=arm&... is answered with {"drive": {...}, "arm": {...}}.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The arm commands are split over two raw strings to fit in 80 columns
+constexpr const char * kDefaultScript = R"(
+# Drive: stop, switch into drive, drive straight, turn, spin, stop
+0  drive {"is_operational": 1, "drive_mode": "S", "speed": 0, "angle": 0}
+2  drive {"is_operational": 1, "drive_mode": "D", "speed": 0, "angle": 0}
+4  drive {"is_operational": 1, "drive_mode": "D", "speed": 20, "angle": 0}
+9  drive {"is_operational": 1, "drive_mode": "D", "speed": 20, "angle": 15}
+14 drive {"is_operational": 1, "drive_mode": "S", "speed": 10, "angle": 0}
+19 drive {"is_operational": 1, "drive_mode": "D", "speed": 0, "angle": 0}
+# Arm: hold at home, then reach forward
+0  arm {"is_operational": 1, "rotunda": 0, "shoulder": 0, "elbow": 0,)"
+    R"( "wrist_pitch": 0, "wrist_roll": 0}
+5  arm {"is_operational": 1, "rotunda": 30, "shoulder": 45, "elbow": 60,)"
+    R"( "wrist_pitch": -15, "wrist_roll": 0}
+)";
+
+/// Endpoint that answers for several subsystems at once, and the query
+/// parameter naming each of them
+constexpr std::string_view kBatchEndpoint   = "rover";
+constexpr std::string_view kSubsystemPrefix = "subsystem=";
+/// Statistics are printed this often while serving
+constexpr auto kReportPeriod = std::chrono::seconds(5);
+/// Requests are not expected to have bodies, so anything longer is an error
+constexpr size_t kMaxRequestSize = 8192;
+
+struct Command
+{
+  double time = 0;
+  std::string body;
+};
+
+/// Commands of one endpoint, sorted by time
+struct Endpoint
+{
+  std::vector<Command> commands;
+  uint64_t requests = 0;
+};
+
+struct Connection
+{
+  std::string received;
+};
+
+volatile std::sig_atomic_t is_stopping = 0;
+
+bool ParseScript(std::istream & script,
+                 std::map<std::string, Endpoint, std::less<>> & endpoints)
+{
+  std::string line;
+  int line_number = 0;
+  while (std::getline(script, line))
+  {
+    line_number++;
+    size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#')
+    {
+      continue;
+    }
+
+    std::istringstream fields(line);
+    Command command;
+    std::string name;
+    if (!(fields >> command.time >> name))
+    {
+      fprintf(stderr, "Script line %d: expected <time> <endpoint> <json>\n",
+              line_number);
+      return false;
+    }
+    std::getline(fields >> std::ws, command.body);
+    while (!command.body.empty() && command.body.back() == '\r')
+    {
+      command.body.pop_back();
+    }
+    endpoints[name].commands.push_back(command);
+  }
+
+  for (auto & [name, endpoint] : endpoints)
+  {
+    std::stable_sort(endpoint.commands.begin(), endpoint.commands.end(),
+                     [](const Command & a, const Command & b) {
+                       return a.time < b.time;
+                     });
+  }
+  return true;
+}
+
+/// @return the command for the time since the server started, nullptr if
+///         the endpoint has not started yet
+const Command * GetCommand(const Endpoint & endpoint, double elapsed)
+{
+  const Command * current = nullptr;
+  for (const Command & command : endpoint.commands)
+  {
+    if (command.time > elapsed)
+    {
+      break;
+    }
+    current = &command;
+  }
+  return current;
+}
+
+bool ContainsCaseInsensitive(std::string_view text, std::string_view pattern)
+{
+  auto found = std::search(
+      text.begin(), text.end(), pattern.begin(), pattern.end(),
+      [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+  return found != text.end();
+}
+
+void SendAll(int fd, std::string_view data)
+{
+  while (!data.empty())
+  {
+    ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+      if (errno == EAGAIN || errno == EINTR)
+      {
+        pollfd descriptor = { .fd = fd, .events = POLLOUT, .revents = 0 };
+        poll(&descriptor, 1, 100);
+        continue;
+      }
+      return;
+    }
+    data.remove_prefix(static_cast<size_t>(sent));
+  }
+}
+
+class Server
+{
+ public:
+  explicit Server(std::map<std::string, Endpoint, std::less<>> endpoints)
+      : endpoints_(std::move(endpoints)),
+        start_(std::chrono::steady_clock::now())
+  {
+  }
+
+  bool Listen(uint16_t port)
+  {
+    listener_ = socket(AF_INET6, SOCK_STREAM, 0);
+    if (listener_ < 0)
+    {
+      perror("socket");
+      return false;
+    }
+    int enable = 1;
+    setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    // Accept IPv4 clients on the same socket
+    int disable = 0;
+    setsockopt(listener_, IPPROTO_IPV6, IPV6_V6ONLY, &disable,
+               sizeof(disable));
+
+    sockaddr_in6 address = {};
+    address.sin6_family  = AF_INET6;
+    address.sin6_addr    = in6addr_any;
+    address.sin6_port    = htons(port);
+    if (bind(listener_, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+        listen(listener_, SOMAXCONN) != 0)
+    {
+      perror("bind");
+      return false;
+    }
+    fcntl(listener_, F_SETFL, fcntl(listener_, F_GETFL) | O_NONBLOCK);
+    printf("Mission control stand-in listening on port %u\n",
+           static_cast<unsigned>(port));
+    return true;
+  }
+
+  void Serve()
+  {
+    auto next_report = std::chrono::steady_clock::now() + kReportPeriod;
+    std::vector<pollfd> descriptors;
+    while (!is_stopping)
+    {
+      descriptors.clear();
+      descriptors.push_back(
+          { .fd = listener_, .events = POLLIN, .revents = 0 });
+      for (const auto & [fd, connection] : connections_)
+      {
+        descriptors.push_back({ .fd = fd, .events = POLLIN, .revents = 0 });
+      }
+
+      int ready = poll(descriptors.data(), descriptors.size(), 100);
+      if (ready < 0 && errno != EINTR)
+      {
+        perror("poll");
+        return;
+      }
+      for (const pollfd & descriptor : descriptors)
+      {
+        if (descriptor.revents == 0)
+        {
+          continue;
+        }
+        if (descriptor.fd == listener_)
+        {
+          Accept();
+        }
+        else
+        {
+          Receive(descriptor.fd);
+        }
+      }
+
+      if (std::chrono::steady_clock::now() >= next_report)
+      {
+        Report();
+        next_report += kReportPeriod;
+      }
+    }
+    Report();
+  }
+
+ private:
+  void Accept()
+  {
+    while (true)
+    {
+      int fd = accept(listener_, nullptr, nullptr);
+      if (fd < 0)
+      {
+        return;
+      }
+      int enable = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+      connections_[fd] = {};
+      accepted_++;
+    }
+  }
+
+  void Receive(int fd)
+  {
+    char buffer[4096];
+    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+    {
+      if (received < 0 && (errno == EAGAIN || errno == EINTR))
+      {
+        return;
+      }
+      Drop(fd);
+      return;
+    }
+
+    std::string & pending = connections_[fd].received;
+    pending.append(buffer, static_cast<size_t>(received));
+    // Clients may pipeline, answer every complete request received
+    size_t end;
+    while ((end = pending.find("\r\n\r\n")) != std::string::npos)
+    {
+      std::string request = pending.substr(0, end);
+      pending.erase(0, end + 4);
+      if (!Respond(fd, request))
+      {
+        Drop(fd);
+        return;
+      }
+    }
+    if (pending.size() > kMaxRequestSize)
+    {
+      Drop(fd);
+    }
+  }
+
+  /// @return false if the connection should be closed
+  bool Respond(int fd, std::string_view request)
+  {
+    // GET /path/endpoint?parameters HTTP/1.1
+    std::string_view line = request.substr(0, request.find("\r\n"));
+    size_t path_start     = line.find(' ');
+    size_t path_end       = line.rfind(' ');
+    if (path_start == std::string_view::npos || path_end <= path_start)
+    {
+      SendAll(fd, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n");
+      return false;
+    }
+    std::string_view path =
+        line.substr(path_start + 1, path_end - path_start - 1);
+    size_t query_start     = std::min(path.find('?'), path.size());
+    std::string_view query = path.substr(query_start);
+    path                   = path.substr(0, query_start);
+    std::string_view name  = path.substr(path.rfind('/') + 1);
+
+    bool keep_alive = !ContainsCaseInsensitive(request, "connection: close");
+    const char * connection = keep_alive ? "keep-alive" : "close";
+
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+    std::string body;
+    bool found = (name == kBatchEndpoint) ? GetBatchBody(query, elapsed, body)
+                                          : GetBody(name, elapsed, body);
+    if (!found)
+    {
+      char response[128];
+      snprintf(response, sizeof(response),
+               "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+               "Connection: %s\r\n\r\n",
+               connection);
+      SendAll(fd, response);
+      return keep_alive;
+    }
+
+    char header[192];
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+             "Content-Length: %zu\r\nConnection: %s\r\n\r\n",
+             body.size(), connection);
+    std::string response = header;
+    response += body;
+    SendAll(fd, response);
+    return keep_alive;
+  }
+
+  /// @return false if the endpoint has no command yet
+  bool GetBody(std::string_view name, double elapsed, std::string & body)
+  {
+    auto endpoint = endpoints_.find(name);
+    if (endpoint == endpoints_.end())
+    {
+      return false;
+    }
+    const Command * command = GetCommand(endpoint->second, elapsed);
+    if (command == nullptr)
+    {
+      return false;
+    }
+    endpoint->second.requests++;
+    body = command->body;
+    return true;
+  }
+
+  /// Answers every subsystem named in the query with one object each, like
+  /// MissionControlExchange expects
+  /// @return false if none of the subsystems has a command yet
+  bool GetBatchBody(std::string_view query, double elapsed, std::string & body)
+  {
+    body = "{";
+    while (!query.empty())
+    {
+      query.remove_prefix(1);
+      size_t end                 = query.find('&');
+      std::string_view parameter = query.substr(0, end);
+      query = query.substr(std::min(end, query.size()));
+      if (!parameter.starts_with(kSubsystemPrefix))
+      {
+        continue;
+      }
+      std::string_view subsystem = parameter.substr(kSubsystemPrefix.size());
+      std::string subsystem_body;
+      if (GetBody(subsystem, elapsed, subsystem_body))
+      {
+        body += (body.size() > 1) ? ", \"" : "\"";
+        body += subsystem;
+        body += "\": ";
+        body += subsystem_body;
+      }
+    }
+    body += "}";
+    return body.size() > 2;
+  }
+
+  void Drop(int fd)
+  {
+    close(fd);
+    connections_.erase(fd);
+  }
+
+  void Report()
+  {
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+    printf("[%8.1fs] %zu open / %lu accepted connections", elapsed,
+           connections_.size(), static_cast<unsigned long>(accepted_));
+    for (auto & [name, endpoint] : endpoints_)
+    {
+      printf(", %s: %lu (%.0f/s)", name.c_str(),
+             static_cast<unsigned long>(endpoint.requests),
+             static_cast<double>(endpoint.requests - endpoint_reported_[name]) /
+                 std::chrono::duration<double>(kReportPeriod).count());
+      endpoint_reported_[name] = endpoint.requests;
+    }
+    printf("\n");
+    fflush(stdout);
+  }
+
+  std::map<std::string, Endpoint, std::less<>> endpoints_;
+  std::map<std::string, uint64_t> endpoint_reported_;
+  std::map<int, Connection> connections_;
+  std::chrono::steady_clock::time_point start_;
+  int listener_      = -1;
+  uint64_t accepted_ = 0;
+};
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  uint16_t port           = 8080;
+  const char * script_path = nullptr;
+  int option;
+  while ((option = getopt(argc, argv, "p:s:")) != -1)
+  {
+    switch (option)
+    {
+      case 'p': port = static_cast<uint16_t>(atoi(optarg)); break;
+      case 's': script_path = optarg; break;
+      default:
+        fprintf(stderr, "usage: %s [-p port] [-s script]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  std::map<std::string, Endpoint, std::less<>> endpoints;
+  if (script_path != nullptr)
+  {
+    std::ifstream script(script_path);
+    if (!script)
+    {
+      fprintf(stderr, "Cannot open %s\n", script_path);
+      return 1;
+    }
+    if (!ParseScript(script, endpoints))
+    {
+      return 1;
+    }
+  }
+  else
+  {
+    std::istringstream script(kDefaultScript);
+    ParseScript(script, endpoints);
+  }
+
+  signal(SIGINT, [](int) { is_stopping = 1; });
+  signal(SIGTERM, [](int) { is_stopping = 1; });
+
+  Server server(std::move(endpoints));
+  if (!server.Listen(port))
+  {
+    return 1;
+  }
+  server.Serve();
+  return 0;
+}
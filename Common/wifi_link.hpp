@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "devices/communication/esp8266.hpp"
+#include "utility/log.hpp"
+#include "utility/time/time.hpp"
+
+namespace sjsu::common
+{
+/// WiFiLink keeps a WiFi network association up without ever blocking for
+/// longer than a single association attempt. Update() is meant to be called
+/// every tick of the task that owns the network: it only compares times
+/// unless an attempt or a link check is due.
+///
+/// Failed attempts are retried with exponential backoff, from kFirstBackoff
+/// up to kMaxBackoff. Once up, the link is checked every kCheckPeriod, or on
+/// the next Update() after ReportFailure(). How long each outage lasted is
+/// kept in the statistics.
+class WiFiLink
+{
+ public:
+  using UptimeFunction = std::chrono::nanoseconds (*)();
+
+  /// Longest a single association attempt blocks Update()
+  static constexpr std::chrono::nanoseconds kAssociationTimeout = 5s;
+  static constexpr std::chrono::nanoseconds kFirstBackoff       = 250ms;
+  static constexpr std::chrono::nanoseconds kMaxBackoff         = 16s;
+  static constexpr std::chrono::nanoseconds kCheckPeriod        = 1s;
+
+  struct Statistics_t
+  {
+    /// Times the link went down after being up
+    uint32_t dropouts = 0;
+    uint32_t attempts = 0;
+    /// Time from losing the link, or from boot, until it was back up
+    std::chrono::nanoseconds last_recovery_time    = 0ns;
+    std::chrono::nanoseconds longest_recovery_time = 0ns;
+  };
+
+  /// @param wifi network module
+  /// @param ssid network name, must outlive the link
+  /// @param password network password, must outlive the link
+  /// @param uptime clock used for backoff and measurements
+  WiFiLink(sjsu::WiFi & wifi,
+           const char * ssid,
+           const char * password,
+           UptimeFunction uptime = sjsu::Uptime)
+      : wifi_(wifi), ssid_(ssid), password_(password), uptime_(uptime)
+  {
+  }
+
+  /// Attempts to associate or checks the link, if either is due
+  /// @return true if the link is up
+  bool Update()
+  {
+    std::chrono::nanoseconds now = uptime_();
+    if (is_up_)
+    {
+      if (now >= next_check_)
+      {
+        Check(now);
+      }
+    }
+    else if (now >= next_attempt_)
+    {
+      Associate(now);
+    }
+    return is_up_;
+  }
+
+  /// Reports that traffic over the link failed, so the link is checked on
+  /// the next Update() instead of waiting for the check period
+  void ReportFailure()
+  {
+    next_check_ = 0ns;
+  }
+
+  bool IsUp() const
+  {
+    return is_up_;
+  }
+
+  /// @return wait after the next failed attempt
+  std::chrono::nanoseconds GetBackoff() const
+  {
+    return backoff_;
+  }
+
+  const Statistics_t & GetStatistics() const
+  {
+    return statistics_;
+  }
+
+ private:
+  void Check(std::chrono::nanoseconds now)
+  {
+    next_check_ = now + kCheckPeriod;
+    if (wifi_.IsConnected())
+    {
+      return;
+    }
+    sjsu::LogWarning("Lost connection to %s, reconnecting...", ssid_);
+    is_up_        = false;
+    down_since_   = now;
+    next_attempt_ = now;
+    statistics_.dropouts++;
+  }
+
+  void Associate(std::chrono::nanoseconds now)
+  {
+    // Scheduled before attempting, so an attempt that throws still backs off
+    std::chrono::nanoseconds wait = backoff_;
+    next_attempt_                 = now + wait;
+    backoff_                      = std::min(backoff_ * 2, kMaxBackoff);
+    statistics_.attempts++;
+
+    sjsu::LogInfo("Attempting to connect to %s...", ssid_);
+    if (!wifi_.ConnectToAccessPoint(ssid_, password_, kAssociationTimeout))
+    {
+      sjsu::LogError("Failed to connect to %s, retrying in %lu ms", ssid_,
+                     static_cast<unsigned long>(ToMilliseconds(wait)));
+      wifi_.DisconnectFromAccessPoint();
+      return;
+    }
+
+    std::chrono::nanoseconds connected_at = uptime_();
+    is_up_                                = true;
+    backoff_                              = kFirstBackoff;
+    next_check_                           = connected_at + kCheckPeriod;
+    statistics_.last_recovery_time        = connected_at - down_since_;
+    statistics_.longest_recovery_time =
+        std::max(statistics_.longest_recovery_time,
+                 statistics_.last_recovery_time);
+    sjsu::LogInfo("Connected to %s after %lu ms", ssid_,
+                  static_cast<unsigned long>(
+                      ToMilliseconds(statistics_.last_recovery_time)));
+  }
+
+  static int64_t ToMilliseconds(std::chrono::nanoseconds duration)
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+        .count();
+  }
+
+  sjsu::WiFi & wifi_;
+  const char * ssid_;
+  const char * password_;
+  UptimeFunction uptime_;
+  bool is_up_                            = false;
+  std::chrono::nanoseconds down_since_   = 0ns;
+  std::chrono::nanoseconds next_attempt_ = 0ns;
+  std::chrono::nanoseconds next_check_   = 0ns;
+  std::chrono::nanoseconds backoff_      = kFirstBackoff;
+  Statistics_t statistics_;
+};
+}  // namespace sjsu::common
@@ -0,0 +1,126 @@
+// Host benchmark of the per-tick steering math of velocity mode, run on the
+// real SwerveKinematics, Wheel and RoverDriveSystem with a CAN bus that drops
+// every frame. Times come from CycleCounter, which counts nanoseconds of the
+// steady clock on the host and CPU cycles on the LPC40xx. These are host
+// numbers only: no on-target measurement has been taken with this benchmark.
+// On the rover the actuation task logs the same counter for a whole tick as
+// "actuation: ... cycles".
+//
+// Build & run: make -C Drive/benchmark run (needs SJSU-Dev2, see makefile)
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/math/units.hpp"
+
+#include "../../Common/cycle_counter.hpp"
+#include "../rover_drive_system.hpp"
+#include "../swerve_kinematics.hpp"
+#include "../wheel.hpp"
+#include "null_can.hpp"
+
+namespace
+{
+using sjsu::common::CycleCounter;
+using sjsu::common::CycleStatistics;
+
+constexpr int kBatches   = 10'000;
+constexpr int kBatchSize = 100;
+
+/// Stops the compiler from optimizing the math away
+void Escape(void * pointer)
+{
+  asm volatile("" : : "g"(pointer) : "memory");
+}
+
+/// Sweeps through forward speeds and turn rates so every wheel flips its hub
+/// and every branch is taken
+sjsu::drive::BodyVelocity GetVelocity(int i)
+{
+  return { 0.5f, 0.0f, static_cast<float>(i % 200 - 100) / 50.0f };
+}
+
+/// Times a stage in batches, since a single call is close to the resolution
+/// of the host's clock
+template <typename Stage>
+void Run(const char * name, Stage stage)
+{
+  for (int i = 0; i < kBatches * kBatchSize / 10; i++)
+  {
+    stage(i);
+  }
+
+  CycleStatistics statistics;
+  int i = 0;
+  for (int batch = 0; batch < kBatches; batch++)
+  {
+    uint32_t start = CycleCounter::Now();
+    for (int call = 0; call < kBatchSize; call++)
+    {
+      stage(i++);
+    }
+    statistics.Record(CycleCounter::Now() - start);
+  }
+
+  printf("%-34s %10.1f %10.1f %10.1f\n", name,
+         static_cast<double>(statistics.GetMin()) / kBatchSize,
+         static_cast<double>(statistics.GetMean()) / kBatchSize,
+         static_cast<double>(statistics.GetMax()) / kBatchSize);
+}
+}  // namespace
+
+int main()
+{
+  CycleCounter::Enable();
+
+  sjsu::drive::NullCan can;
+  sjsu::StaticMemoryResource<1024> memory_resource;
+  sjsu::CanNetwork network(can, &memory_resource);
+
+  sjsu::RmdX left_steer_motor(network, 0x141);
+  sjsu::RmdX left_hub_motor(network, 0x142);
+  sjsu::RmdX right_steer_motor(network, 0x143);
+  sjsu::RmdX right_hub_motor(network, 0x144);
+  sjsu::RmdX back_steer_motor(network, 0x145);
+  sjsu::RmdX back_hub_motor(network, 0x146);
+
+  sjsu::drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+  sjsu::drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
+  sjsu::drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+  sjsu::drive::RoverDriveSystem drive_system(left_wheel, right_wheel,
+                                             back_wheel);
+
+  using Kinematics = sjsu::drive::RoverDriveSystem::Kinematics;
+  constexpr Kinematics kinematics(sjsu::drive::RoverDriveSystem::kGeometry);
+
+  printf("Host CycleCounter units (ns) per call, batches of %d\n", kBatchSize);
+  printf("%-34s %10s %10s %10s\n", "stage", "min", "mean", "max");
+
+  Run("SwerveKinematics::Solve", [&](int i) {
+    Kinematics::Commands commands = kinematics.Solve(GetVelocity(i), 100_rpm);
+    Escape(&commands);
+  });
+
+  // The angles velocity mode steers the wheels to
+  std::array<Kinematics::Commands, 200> solutions;
+  for (size_t i = 0; i < solutions.size(); i++)
+  {
+    solutions[i] = kinematics.Solve(GetVelocity(static_cast<int>(i)), 100_rpm);
+  }
+  Run("Wheel::SetSteeringPosition x3", [&](int i) {
+    const Kinematics::Commands & commands = solutions[i % solutions.size()];
+    left_wheel.SetSteeringPosition(commands[0].angle);
+    right_wheel.SetSteeringPosition(commands[1].angle);
+    back_wheel.SetSteeringPosition(commands[2].angle);
+  });
+
+  // Solve, steer and send the hub speeds, like HandleVelocityMode()
+  Run("RoverDriveSystem::SetBodyVelocity",
+      [&](int i) { drive_system.SetBodyVelocity(GetVelocity(i)); });
+
+  printf("(%lu CAN frames dropped)\n",
+         static_cast<unsigned long>(can.GetSentCount()));
+  return 0;
+}
@@ -0,0 +1,252 @@
+// Host benchmark of every stage of the drive control tick against a CAN bus
+// that drops every frame: nanoseconds and heap allocations per call. Results
+// are printed as a table and, given a path, written as JSON so runs from
+// different firmware releases can be compared by a script.
+//
+// Build & run: make -C Drive/benchmark run (needs SJSU-Dev2, see makefile)
+//              build/drive_tick_benchmark [results.json]
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include "peripherals/lpc40xx/can.hpp"
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/math/units.hpp"
+
+#include "../../Common/request_writer.hpp"
+#include "../drive_protocol.hpp"
+#include "../flight_record.hpp"
+#include "../motor_feedback.hpp"
+#include "../rover_drive_system.hpp"
+#include "../wheel.hpp"
+#include "null_can.hpp"
+
+namespace
+{
+std::atomic<uint64_t> allocations = 0;
+}  // namespace
+
+void * operator new(size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * pointer = std::malloc(size == 0 ? 1 : size))
+  {
+    return pointer;
+  }
+#if defined(__cpp_exceptions)
+  throw std::bad_alloc();
+#else
+  std::abort();
+#endif
+}
+
+void operator delete(void * pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void * pointer, size_t) noexcept
+{
+  std::free(pointer);
+}
+
+namespace
+{
+using sjsu::Can;
+
+constexpr int kIterations = 100'000;
+
+constexpr std::string_view kResponse =
+    R"({"is_operational": 1, "drive_mode": "D", "speed": 15.25, "angle": 0})";
+
+struct Result_t
+{
+  const char * name;
+  int iterations;
+  double nanoseconds_per_op;
+  double allocations_per_op;
+};
+
+std::array<Result_t, 16> results;
+size_t result_count = 0;
+
+/// Stops the compiler from optimizing the work away
+void Escape(void * pointer)
+{
+  asm volatile("" : : "g"(pointer) : "memory");
+}
+
+/// Runs a stage kIterations times with log output thrown away, since
+/// printing to a terminal would swamp the measurement. Formatting the log
+/// lines still counts.
+template <typename Stage>
+void Run(const char * name, Stage stage, int iterations = kIterations)
+{
+  fflush(stdout);
+  int saved_stdout = dup(STDOUT_FILENO);
+  int null_output  = open("/dev/null", O_WRONLY);
+  dup2(null_output, STDOUT_FILENO);
+  close(null_output);
+
+  for (int i = 0; i < iterations / 10; i++)
+  {
+    stage();
+  }
+
+  uint64_t start_allocations = allocations.load();
+  auto start_time            = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    stage();
+  }
+  auto end_time            = std::chrono::steady_clock::now();
+  uint64_t end_allocations = allocations.load();
+
+  fflush(stdout);
+  dup2(saved_stdout, STDOUT_FILENO);
+  close(saved_stdout);
+
+  double nanoseconds =
+      std::chrono::duration<double, std::nano>(end_time - start_time).count();
+  results[result_count++] = {
+    name, iterations, nanoseconds / iterations,
+    static_cast<double>(end_allocations - start_allocations) / iterations
+  };
+}
+
+void PrintTable()
+{
+  printf("%-28s %12s %12s %14s\n", "stage", "iterations", "ns/op",
+         "allocations/op");
+  for (size_t i = 0; i < result_count; i++)
+  {
+    const Result_t & result = results[i];
+    printf("%-28s %12d %12.1f %14.2f\n", result.name, result.iterations,
+           result.nanoseconds_per_op, result.allocations_per_op);
+  }
+}
+
+bool WriteJson(const char * path)
+{
+  FILE * file = fopen(path, "w");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  fprintf(file, "{\n  \"benchmark\": \"drive_tick\",\n  \"results\": [\n");
+  for (size_t i = 0; i < result_count; i++)
+  {
+    const Result_t & result = results[i];
+    fprintf(file,
+            "    {\"name\": \"%s\", \"iterations\": %d, \"ns_per_op\": %.1f, "
+            "\"allocations_per_op\": %.2f}%s\n",
+            result.name, result.iterations, result.nanoseconds_per_op,
+            result.allocations_per_op, (i + 1 < result_count) ? "," : "");
+  }
+  fprintf(file, "  ]\n}\n");
+  fclose(file);
+  return true;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  // Drops frames without recording them, so every allocation counted below
+  // is made by the drive code
+  sjsu::drive::NullCan can;
+  sjsu::StaticMemoryResource<1024> memory_resource;
+  sjsu::CanNetwork network(can, &memory_resource);
+
+  sjsu::RmdX left_steer_motor(network, 0x141);
+  sjsu::RmdX left_hub_motor(network, 0x142);
+  sjsu::RmdX right_steer_motor(network, 0x143);
+  sjsu::RmdX right_hub_motor(network, 0x144);
+  sjsu::RmdX back_steer_motor(network, 0x145);
+  sjsu::RmdX back_hub_motor(network, 0x146);
+
+  sjsu::drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+  sjsu::drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
+  sjsu::drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+  sjsu::drive::RoverDriveSystem drive_system(left_wheel, right_wheel,
+                                             back_wheel);
+  sjsu::drive::MotorFeedbackCache<6> feedback(network, { { { 0x141, 8 },
+                                                           { 0x142, 8 },
+                                                           { 0x143, 8 },
+                                                           { 0x144, 8 },
+                                                           { 0x145, 8 },
+                                                           { 0x146, 8 } } });
+  drive_system.SetSpeedRamp({}, 10ms);
+
+  // Into drive mode before timing the ticks
+  drive_system.ParseJSONResponse(kResponse);
+  drive_system.HandleRoverMovement();
+
+  // Cost of the bus stand-in itself, included in every stage that sends
+  Can & bus = can;
+  Can::Message_t message;
+  Run("null can send", [&]() { bus.Send(message); });
+
+  sjsu::common::StaticRequestWriter<300> writer;
+  Run("CreateRequestParameters", [&]() {
+    writer.Clear();
+    drive_system.CreateRequestParameters(writer);
+    Escape(&writer);
+  });
+  Run("ParseJSONResponse",
+      [&]() { drive_system.ParseJSONResponse(kResponse); });
+
+  std::array<uint8_t, sjsu::drive::protocol::kTelemetryFrameSize> frame;
+  Run("CreateTelemetryFrame",
+      [&]() { drive_system.CreateTelemetryFrame(frame); });
+
+  Run("Wheel::SetHubSpeed", [&]() { left_wheel.SetHubSpeed(15_rpm); });
+
+  float angle = 0.0f;
+  Run("Wheel::SetSteeringPosition", [&]() {
+    angle = (angle > 170.0f) ? -170.0f : angle + 10.0f;
+    left_wheel.SetSteeringPosition(units::angle::degree_t(angle));
+  });
+
+  Run("HandleRoverMovement", [&]() { drive_system.HandleRoverMovement(); });
+
+  Run("MotorFeedbackCache::Update", [&]() { feedback.Update(); });
+
+  // Should stay well under 1% of the 10ms control period
+  static sjsu::drive::DriveFlightRecorder flight_recorder;
+  Run("flight recorder capture",
+      [&]() { flight_recorder.Capture(drive_system.GetFlightRecord()); });
+
+  // Same steps as ActuationTask::Actuate()
+  float speed = 0.0f;
+  Run("full tick", [&]() {
+    speed = (speed > 90.0f) ? -90.0f : speed + 1.0f;
+    drive_system.mc_data.speed = speed;
+    feedback.Update();
+    drive_system.HandleRoverMovement();
+    drive_system.UpdateWheelSpeeds();
+    sjsu::drive::protocol::DriveTelemetry telemetry =
+        drive_system.GetTelemetry();
+    Escape(&telemetry);
+  });
+
+  PrintTable();
+  if (argc > 1)
+  {
+    if (!WriteJson(argv[1]))
+    {
+      fprintf(stderr, "Unable to write %s\n", argv[1]);
+      return 1;
+    }
+    printf("Results written to %s\n", argv[1]);
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+// Host benchmark comparing ParseMissionControlData() against the sscanf()
+// based parser it replaced in RoverDriveSystem::ParseJSONResponse.
+//
+// Build & run: make -C Drive/benchmark run
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../mission_control_data.hpp"
+
+namespace
+{
+constexpr int kIterations = 1'000'000;
+
+constexpr std::string_view kResponse =
+    R"({ "is_operational": 1, "drive_mode": "D", "speed": 15.25, "angle": -20.5 })";
+
+/// The previous implementation, kept here as the baseline
+void ParseWithSscanf(std::string_view response,
+                     sjsu::drive::MissionControlData & data)
+{
+  sscanf(
+      response.data(),
+      R"({ "is_operational": %d, "drive_mode": "%c", "speed": %f, "angle": %f }\n)",
+      &data.is_operational, &data.drive_mode, &data.speed,
+      &data.rotation_angle);
+}
+
+/// Stops the compiler from optimizing the parse away
+void Escape(void * pointer)
+{
+  asm volatile("" : : "g"(pointer) : "memory");
+}
+
+uint64_t ReadCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template <typename Parser>
+void Run(const char * name, Parser parser)
+{
+  sjsu::drive::MissionControlData data;
+  // Warm up caches and branch predictors
+  for (int i = 0; i < kIterations / 10; i++)
+  {
+    parser(kResponse, data);
+    Escape(&data);
+  }
+
+  auto start_time     = std::chrono::steady_clock::now();
+  uint64_t start_tick = ReadCycles();
+  for (int i = 0; i < kIterations; i++)
+  {
+    parser(kResponse, data);
+    Escape(&data);
+  }
+  uint64_t end_tick = ReadCycles();
+  auto end_time     = std::chrono::steady_clock::now();
+
+  double nanoseconds =
+      std::chrono::duration<double, std::nano>(end_time - start_time).count();
+  printf("%-24s %8.1f ns/parse %8.1f cycles/parse  (speed=%.2f angle=%.2f)\n",
+         name, nanoseconds / kIterations,
+         static_cast<double>(end_tick - start_tick) / kIterations,
+         static_cast<double>(data.speed),
+         static_cast<double>(data.rotation_angle));
+}
+}  // namespace
+
+int main()
+{
+  printf("Parsing %zu byte response %d times\n", kResponse.size(),
+         kIterations);
+  Run("sscanf", ParseWithSscanf);
+  Run("ParseMissionControlData",
+      [](std::string_view response, sjsu::drive::MissionControlData & data) {
+        sjsu::drive::ParseMissionControlData(response, data);
+      });
+  return 0;
+}
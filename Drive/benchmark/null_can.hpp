@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#include "peripherals/lpc40xx/can.hpp"
+
+namespace sjsu::drive
+{
+/// CAN peripheral for host benchmarks that drops every frame sent and never
+/// receives one. Unlike a FakeIt mock it records nothing, so it neither
+/// allocates nor takes time that would be blamed on the drive code.
+class NullCan final : public sjsu::Can
+{
+ public:
+  void ModuleInitialize() override {}
+
+  void Send(const Message_t &) override
+  {
+    sent_++;
+  }
+
+  Message_t Receive() override
+  {
+    return {};
+  }
+
+  bool HasData() override
+  {
+    return false;
+  }
+
+  /// @return number of frames dropped, so the sends can't be optimized away
+  uint32_t GetSentCount() const
+  {
+    return sent_;
+  }
+
+ private:
+  uint32_t sent_ = 0;
+};
+}  // namespace sjsu::drive
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+
+#include "utility/time/time.hpp"
+
+#include "../Common/mailbox.hpp"
+#include "../Common/mission_control_exchange.hpp"
+#include "drive_protocol.hpp"
+#include "mission_control_data.hpp"
+#include "rover_drive_system.hpp"
+#include "telemetry_delta.hpp"
+
+namespace sjsu::drive
+{
+/// Latest command from mission control and when it arrived
+struct TimestampedCommand
+{
+  MissionControlData data;
+  std::chrono::nanoseconds received_at = 0ns;
+};
+
+using CommandMailbox   = common::Mailbox<TimestampedCommand>;
+using TelemetryMailbox = common::Mailbox<protocol::DriveTelemetry>;
+
+/// Drive side of the mission control exchange: reports the telemetry the
+/// actuation task posts and posts the commands that come back to it
+class DriveClient final : public common::MissionControlClient
+{
+ public:
+  static constexpr std::string_view kName = "drive";
+
+  DriveClient(CommandMailbox & commands, TelemetryMailbox & telemetry)
+      : commands_(commands), telemetry_(telemetry)
+  {
+  }
+
+  std::string_view GetName() const override
+  {
+    return kName;
+  }
+
+  std::string_view GetEndpoint() const override
+  {
+    return RoverDriveSystem::kEndpoint;
+  }
+
+  void WriteTelemetry(common::RequestWriter & request) override
+  {
+    telemetry_.Read(latest_telemetry_);
+    telemetry_encoder_.Write(request, latest_telemetry_);
+  }
+
+  common::Status ReceiveCommands(std::string_view json) override
+  {
+    // Missing fields keep the value of the previous command
+    if (ParseMissionControlData(json, command_.data) == 0)
+    {
+      return common::Status::kBadResponse;
+    }
+    // A response means mission control saw the telemetry fields
+    telemetry_encoder_.Acknowledge();
+    command_.received_at = sjsu::Uptime();
+    commands_.Write(command_);
+    return common::Status::kOk;
+  }
+
+ private:
+  CommandMailbox & commands_;
+  TelemetryMailbox & telemetry_;
+  protocol::DriveTelemetry latest_telemetry_;
+  /// Only sends the telemetry fields that changed
+  TelemetryDeltaEncoder telemetry_encoder_;
+  TimestampedCommand command_;
+};
+}  // namespace sjsu::drive
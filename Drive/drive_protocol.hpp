@@ -0,0 +1,317 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+
+#include "mission_control_data.hpp"
+
+namespace sjsu::drive
+{
+/// Compact binary alternative to the JSON command / query string telemetry
+/// exchanged with mission control. Every frame is fixed size and little
+/// endian:
+///
+///     byte 0      kFrameMagic
+///     byte 1      kProtocolVersion
+///     byte 2      FrameType
+///     byte 3-4    sequence number
+///     byte 5-N    payload (see Encode functions)
+///     last 2      CRC-16/CCITT-FALSE of every byte before it
+///
+/// Speeds are sent in 0.01 rpm and angles in 0.1 degree units as int16, so
+/// neither side formats or parses floats as text.
+namespace protocol
+{
+constexpr uint8_t kFrameMagic      = 0xA5;
+constexpr uint8_t kProtocolVersion = 1;
+constexpr size_t kHeaderSize       = 5;
+constexpr size_t kCrcSize          = 2;
+
+enum class FrameType : uint8_t
+{
+  kCommand   = 0x01,
+  kTelemetry = 0x02,
+};
+
+enum class FrameStatus : uint8_t
+{
+  kOk,
+  kTooShort,
+  kBadMagic,
+  kBadVersion,
+  kBadType,
+  kBadCrc,
+};
+
+/// Speed and steering angle of one wheel
+struct WheelTelemetry
+{
+  float speed = 0.0f;
+  float angle = 0.0f;
+};
+
+/// Everything the rover reports back each tick. Mirrors the parameters of
+/// RoverDriveSystem::CreateRequestParameters().
+struct DriveTelemetry
+{
+  int is_operational = 0;
+  char drive_mode    = 'S';
+  int battery        = 0;
+  WheelTelemetry left;
+  WheelTelemetry right;
+  WheelTelemetry back;
+};
+
+/// is_operational, drive_mode, speed, angle
+constexpr size_t kCommandPayloadSize = 1 + 1 + 2 + 2;
+/// is_operational, drive_mode, battery, 3 x (speed, angle)
+constexpr size_t kTelemetryPayloadSize = 1 + 1 + 1 + 3 * (2 + 2);
+constexpr size_t kCommandFrameSize =
+    kHeaderSize + kCommandPayloadSize + kCrcSize;
+constexpr size_t kTelemetryFrameSize =
+    kHeaderSize + kTelemetryPayloadSize + kCrcSize;
+
+constexpr float kSpeedScale = 100.0f;  // 0.01 rpm per count
+constexpr float kAngleScale = 10.0f;   // 0.1 degree per count
+
+/// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) using a 16 entry nibble
+/// table, small enough for flash and fast enough for a few dozen bytes.
+inline uint16_t Crc16(std::span<const uint8_t> data)
+{
+  constexpr std::array<uint16_t, 16> kTable = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  };
+  uint16_t crc = 0xFFFF;
+  for (uint8_t byte : data)
+  {
+    crc = static_cast<uint16_t>((crc << 4) ^
+                                kTable[(crc >> 12) ^ (byte >> 4)]);
+    crc = static_cast<uint16_t>((crc << 4) ^
+                                kTable[(crc >> 12) ^ (byte & 0x0F)]);
+  }
+  return crc;
+}
+
+/// Converts to a fixed point count, rounding and saturating to int16
+inline int16_t ToFixed(float value, float scale)
+{
+  float scaled = value * scale;
+  scaled += (scaled < 0.0f) ? -0.5f : 0.5f;
+  if (scaled >= 32767.0f)
+  {
+    return INT16_MAX;
+  }
+  if (scaled <= -32768.0f)
+  {
+    return INT16_MIN;
+  }
+  return static_cast<int16_t>(scaled);
+}
+
+inline float FromFixed(int16_t value, float scale)
+{
+  return static_cast<float>(value) / scale;
+}
+
+/// Writes frames field by field in little endian order
+class FrameWriter
+{
+ public:
+  explicit FrameWriter(std::span<uint8_t> frame) : frame_(frame) {}
+
+  void WriteU8(uint8_t value)
+  {
+    frame_[position_++] = value;
+  }
+
+  void WriteU16(uint16_t value)
+  {
+    WriteU8(static_cast<uint8_t>(value & 0xFF));
+    WriteU8(static_cast<uint8_t>(value >> 8));
+  }
+
+  void WriteI16(int16_t value)
+  {
+    WriteU16(static_cast<uint16_t>(value));
+  }
+
+  void WriteHeader(FrameType type, uint16_t sequence)
+  {
+    WriteU8(kFrameMagic);
+    WriteU8(kProtocolVersion);
+    WriteU8(static_cast<uint8_t>(type));
+    WriteU16(sequence);
+  }
+
+  /// Appends the CRC of everything written so far
+  /// @return total size of the frame
+  size_t Finish()
+  {
+    WriteU16(Crc16(frame_.first(position_)));
+    return position_;
+  }
+
+ private:
+  std::span<uint8_t> frame_;
+  size_t position_ = 0;
+};
+
+/// Reads frames field by field in little endian order
+class FrameReader
+{
+ public:
+  explicit FrameReader(std::span<const uint8_t> frame) : frame_(frame) {}
+
+  uint8_t ReadU8()
+  {
+    return frame_[position_++];
+  }
+
+  uint16_t ReadU16()
+  {
+    uint16_t low = ReadU8();
+    return static_cast<uint16_t>(low | (ReadU8() << 8));
+  }
+
+  int16_t ReadI16()
+  {
+    return static_cast<int16_t>(ReadU16());
+  }
+
+  /// Validates the header and CRC of a frame of the expected type and size
+  /// @param sequence set to the frame's sequence number on success
+  FrameStatus ReadHeader(FrameType type, size_t size, uint16_t & sequence)
+  {
+    if (frame_.size() < size)
+    {
+      return FrameStatus::kTooShort;
+    }
+    uint16_t crc = static_cast<uint16_t>(frame_[size - 2] |
+                                         (frame_[size - 1] << 8));
+    if (ReadU8() != kFrameMagic)
+    {
+      return FrameStatus::kBadMagic;
+    }
+    if (ReadU8() != kProtocolVersion)
+    {
+      return FrameStatus::kBadVersion;
+    }
+    if (ReadU8() != static_cast<uint8_t>(type))
+    {
+      return FrameStatus::kBadType;
+    }
+    if (Crc16(frame_.first(size - kCrcSize)) != crc)
+    {
+      return FrameStatus::kBadCrc;
+    }
+    sequence = ReadU16();
+    return FrameStatus::kOk;
+  }
+
+ private:
+  std::span<const uint8_t> frame_;
+  size_t position_ = 0;
+};
+
+/// Encodes mission control commands. Used by mission control (and tests).
+/// @param frame must hold at least kCommandFrameSize bytes
+/// @return number of bytes written, 0 if frame is too small
+inline size_t EncodeCommandFrame(const MissionControlData & data,
+                                 uint16_t sequence,
+                                 std::span<uint8_t> frame)
+{
+  if (frame.size() < kCommandFrameSize)
+  {
+    return 0;
+  }
+  FrameWriter writer(frame);
+  writer.WriteHeader(FrameType::kCommand, sequence);
+  writer.WriteU8(static_cast<uint8_t>(data.is_operational != 0));
+  writer.WriteU8(static_cast<uint8_t>(data.drive_mode));
+  writer.WriteI16(ToFixed(data.speed, kSpeedScale));
+  writer.WriteI16(ToFixed(data.rotation_angle, kAngleScale));
+  return writer.Finish();
+}
+
+/// Decodes mission control commands. data is only written if the frame is
+/// valid.
+/// @param sequence set to the frame's sequence number on success
+inline FrameStatus DecodeCommandFrame(std::span<const uint8_t> frame,
+                                      MissionControlData & data,
+                                      uint16_t & sequence)
+{
+  FrameReader reader(frame);
+  FrameStatus status =
+      reader.ReadHeader(FrameType::kCommand, kCommandFrameSize, sequence);
+  if (status != FrameStatus::kOk)
+  {
+    return status;
+  }
+  data.is_operational = reader.ReadU8();
+  data.drive_mode     = static_cast<char>(reader.ReadU8());
+  data.speed          = FromFixed(reader.ReadI16(), kSpeedScale);
+  data.rotation_angle = FromFixed(reader.ReadI16(), kAngleScale);
+  return FrameStatus::kOk;
+}
+
+/// Encodes rover telemetry.
+/// @param frame must hold at least kTelemetryFrameSize bytes
+/// @return number of bytes written, 0 if frame is too small
+inline size_t EncodeTelemetryFrame(const DriveTelemetry & telemetry,
+                                   uint16_t sequence,
+                                   std::span<uint8_t> frame)
+{
+  if (frame.size() < kTelemetryFrameSize)
+  {
+    return 0;
+  }
+  FrameWriter writer(frame);
+  writer.WriteHeader(FrameType::kTelemetry, sequence);
+  writer.WriteU8(static_cast<uint8_t>(telemetry.is_operational != 0));
+  writer.WriteU8(static_cast<uint8_t>(telemetry.drive_mode));
+  writer.WriteU8(static_cast<uint8_t>(telemetry.battery));
+  for (const WheelTelemetry * wheel :
+       { &telemetry.left, &telemetry.right, &telemetry.back })
+  {
+    writer.WriteI16(ToFixed(wheel->speed, kSpeedScale));
+    writer.WriteI16(ToFixed(wheel->angle, kAngleScale));
+  }
+  return writer.Finish();
+}
+
+/// Decodes rover telemetry. Used by mission control (and tests).
+/// @param sequence set to the frame's sequence number on success
+inline FrameStatus DecodeTelemetryFrame(std::span<const uint8_t> frame,
+                                        DriveTelemetry & telemetry,
+                                        uint16_t & sequence)
+{
+  FrameReader reader(frame);
+  FrameStatus status =
+      reader.ReadHeader(FrameType::kTelemetry, kTelemetryFrameSize, sequence);
+  if (status != FrameStatus::kOk)
+  {
+    return status;
+  }
+  telemetry.is_operational = reader.ReadU8();
+  telemetry.drive_mode     = static_cast<char>(reader.ReadU8());
+  telemetry.battery        = reader.ReadU8();
+  for (WheelTelemetry * wheel :
+       { &telemetry.left, &telemetry.right, &telemetry.back })
+  {
+    wheel->speed = FromFixed(reader.ReadI16(), kSpeedScale);
+    wheel->angle = FromFixed(reader.ReadI16(), kAngleScale);
+  }
+  return FrameStatus::kOk;
+}
+
+/// @return true if sequence is newer than last, allowing for wrap around
+inline bool IsNewerSequence(uint16_t sequence, uint16_t last)
+{
+  return static_cast<int16_t>(sequence - last) > 0;
+}
+}  // namespace protocol
+}  // namespace sjsu::drive
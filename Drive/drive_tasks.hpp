@@ -0,0 +1,270 @@
+#pragma once
+
+#include <chrono>
+
+#include "L3_Application/task_scheduler.hpp"
+#include "utility/log.hpp"
+#include "utility/rtos.hpp"
+#include "utility/time/time.hpp"
+
+#include "../Common/cycle_counter.hpp"
+#include "../Common/deferred_log.hpp"
+#include "../Common/mission_control_exchange.hpp"
+#include "../Common/periodic_executive.hpp"
+#include "../Common/status.hpp"
+#include "../Common/task_delay.hpp"
+#include "drive_client.hpp"
+#include "flight_record.hpp"
+#include "motor_feedback.hpp"
+#include "rover_drive_system.hpp"
+
+namespace sjsu::drive
+{
+/// Steer and hub motors of all three wheels
+using DriveFeedbackCache = MotorFeedbackCache<6>;
+
+/// Exchanges telemetry for commands with mission control as fast as the
+/// network allows, one round-trip for every client of the exchange. Never
+/// touches the motors, so a slow or failed request only delays when the next
+/// command shows up. Also brings the WiFi up after boot and after every
+/// dropout.
+class NetworkTask final : public sjsu::rtos::Task<2048>
+{
+ public:
+  explicit NetworkTask(common::MissionControlExchange & exchange)
+      : Task("Drive Network", sjsu::rtos::Priority::kLow), exchange_(exchange)
+  {
+  }
+
+  bool Setup() override
+  {
+    exchange_.Initialize();
+    return true;
+  }
+
+  bool Run() override
+  {
+    // While the WiFi reconnects no commands arrive, so the actuation task
+    // stops the rover once the last one is older than kCommandTimeout
+    if (common::Guard([this]() { return exchange_.Exchange(); }) ==
+        common::Status::kException)
+    {
+      sjsu::LogError("Error in network task!");
+    }
+    return true;
+  }
+
+ private:
+  common::MissionControlExchange & exchange_;
+};
+
+/// Drives the motors from the latest command at a fixed high rate regardless
+/// of network latency. Stops the rover if commands stop arriving.
+class ActuationTask final : public sjsu::rtos::Task<1024>
+{
+ public:
+  /// Commands older than this are treated as lost and the rover is stopped
+  static constexpr std::chrono::nanoseconds kCommandTimeout = 1s;
+  static constexpr std::chrono::nanoseconds kControlPeriod  = 10ms;
+  /// Actuating should leave room in the period for the network task
+  static constexpr std::chrono::nanoseconds kActuationBudget = 5ms;
+  /// Timing statistics are logged once every this many cycles
+  static constexpr uint32_t kReportCycles = 1000;
+
+  ActuationTask(RoverDriveSystem & drive_system,
+                DriveFeedbackCache & feedback,
+                CommandMailbox & commands,
+                TelemetryMailbox & telemetry)
+      : Task("Drive Actuation", sjsu::rtos::Priority::kHigh),
+        drive_system_(drive_system),
+        feedback_(feedback),
+        commands_(commands),
+        telemetry_(telemetry),
+        // Blocks between cycles so the lower priority tasks get the CPU
+        executive_(kControlPeriod, sjsu::Uptime, common::TaskDelay)
+  {
+    // Feedback first so telemetry reports this cycle's measurements
+    executive_.AddStep("feedback", [this]() { feedback_.Update(); });
+    executive_.AddStep(
+        "actuation",
+        [this]() {
+          std::chrono::nanoseconds tick_start = sjsu::Uptime();
+          uint32_t start                      = common::CycleCounter::Now();
+          Actuate();
+          uint32_t cycles = common::CycleCounter::Now() - start;
+          actuation_cycles_.Record(cycles);
+          Record(tick_start, cycles);
+        },
+        kActuationBudget);
+  }
+
+  bool Setup() override
+  {
+    common::CycleCounter::Enable();
+    drive_system_.Initialize();
+    return true;
+  }
+
+  /// Runs one control cycle, returning at the start of the next period
+  bool Run() override
+  {
+    executive_.RunCycle();
+    if (executive_.GetCycleCount() % kReportCycles == 0)
+    {
+      executive_.DeferStatistics();
+      common::DeferLogInfo(
+          "actuation: %lu min, %lu mean, %lu max cycles",
+          static_cast<unsigned long>(actuation_cycles_.GetMin()),
+          static_cast<unsigned long>(actuation_cycles_.GetMean()),
+          static_cast<unsigned long>(actuation_cycles_.GetMax()));
+      actuation_cycles_.Reset();
+    }
+    return true;
+  }
+
+  const common::PeriodicExecutive<2> & GetExecutive() const
+  {
+    return executive_;
+  }
+
+  /// @return CPU cycles spent per actuation step since the last report
+  const common::CycleStatistics & GetActuationCycles() const
+  {
+    return actuation_cycles_;
+  }
+
+  /// @return outcome of the latest actuation step
+  common::Status GetLastStatus() const
+  {
+    return last_status_;
+  }
+
+  /// Captures one record per control cycle. The recorder is frozen and a
+  /// dump is requested when a cycle fails, once per fault: a failure that
+  /// repeats every cycle is only dumped again after a cycle succeeded or
+  /// failed differently.
+  void SetFlightRecorder(DriveFlightRecorder & flight_recorder)
+  {
+    flight_recorder_ = &flight_recorder;
+  }
+
+ private:
+  void Record(std::chrono::nanoseconds tick_start, uint32_t cycles)
+  {
+    if (flight_recorder_ == nullptr)
+    {
+      return;
+    }
+    FlightRecord record     = drive_system_.GetFlightRecord();
+    record.timestamp        = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(tick_start)
+            .count());
+    record.actuation_cycles = cycles;
+    if (is_command_stale_)
+    {
+      record.flags |= FlightRecord::kCommandStale;
+    }
+    flight_recorder_->Capture(record);
+  }
+
+  void Actuate()
+  {
+    common::Status status = common::Guard([this]() { return Move(); });
+    if (status == common::Status::kException)
+    {
+      sjsu::LogError("Error in actuation task!");
+    }
+    if (status != common::Status::kOk && status != last_status_ &&
+        flight_recorder_ != nullptr)
+    {
+      flight_recorder_->RequestDump();
+    }
+    last_status_ = status;
+  }
+
+  /// Failures other than exceptions are logged where they happen
+  common::Status Move()
+  {
+    TimestampedCommand command;
+    commands_.Read(command);
+    bool is_stale = (sjsu::Uptime() - command.received_at) > kCommandTimeout ||
+                    commands_.GetWriteCount() == 0;
+    is_command_stale_ = is_stale;
+
+    common::Status status = common::Status::kOk;
+    HomingStatus homing   = drive_system_.GetHomingStatus();
+    // Wheels home in the background, one step per cycle
+    if (homing == HomingStatus::kHoming)
+    {
+      if (drive_system_.UpdateHoming() == HomingStatus::kFailed)
+      {
+        status = common::Status::kHomingFailed;
+      }
+    }
+    else if (homing == HomingStatus::kFailed)
+    {
+      // The steering angles mean nothing without a home, so the rover stays
+      // put until the wheels are homed again
+      drive_system_.SetWheelSpeed(0_rpm);
+      status = common::Status::kHomingFailed;
+    }
+    else if (is_stale || !command.data.is_operational)
+    {
+      drive_system_.SetWheelSpeed(0_rpm);
+    }
+    else
+    {
+      drive_system_.mc_data = command.data;
+      status                = drive_system_.HandleRoverMovement();
+    }
+    // Moves the hubs one step towards whichever speed was just set
+    drive_system_.UpdateWheelSpeeds();
+    telemetry_.Write(drive_system_.GetTelemetry());
+    return status;
+  }
+
+  RoverDriveSystem & drive_system_;
+  DriveFeedbackCache & feedback_;
+  CommandMailbox & commands_;
+  TelemetryMailbox & telemetry_;
+  common::PeriodicExecutive<2> executive_;
+  common::CycleStatistics actuation_cycles_;
+  DriveFlightRecorder * flight_recorder_ = nullptr;
+  bool is_command_stale_                 = true;
+  common::Status last_status_            = common::Status::kOk;
+};
+
+/// Prints the messages the other tasks recorded with common::DeferLogInfo()
+/// and friends, so formatting and the UART only ever cost idle time. Also
+/// prints the flight recorder whenever a dump is requested.
+class LogTask final : public sjsu::rtos::Task<2048>
+{
+ public:
+  LogTask() : Task("Drive Log", sjsu::rtos::Priority::kLow) {}
+
+  bool Setup() override
+  {
+    return true;
+  }
+
+  bool Run() override
+  {
+    common::deferred_log.Drain();
+    if (flight_recorder_ != nullptr && flight_recorder_->TakeDumpRequest())
+    {
+      // Convert the captured console log with flight_recorder_csv
+      flight_recorder_->Dump([](const char * line) { printf("%s\n", line); });
+      flight_recorder_->Resume();
+    }
+    return true;
+  }
+
+  void SetFlightRecorder(DriveFlightRecorder & flight_recorder)
+  {
+    flight_recorder_ = &flight_recorder;
+  }
+
+ private:
+  DriveFlightRecorder * flight_recorder_ = nullptr;
+};
+}  // namespace sjsu::drive
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include "../Common/flight_recorder.hpp"
+#include "drive_protocol.hpp"
+
+namespace sjsu::drive
+{
+/// Commanded and measured state of one wheel, fixed point like the binary
+/// protocol: speeds in protocol::kSpeedScale and angles in
+/// protocol::kAngleScale counts
+struct WheelRecord
+{
+  int16_t commanded_speed = 0;
+  int16_t commanded_angle = 0;
+  int16_t measured_speed  = 0;
+  int16_t measured_angle  = 0;
+};
+
+/// Everything the actuation task saw and did in one control tick
+struct FlightRecord
+{
+  enum Flags : uint8_t
+  {
+    kCommandStale = 1 << 0,
+    kHoming       = 1 << 1,
+    kSwitching    = 1 << 2,
+  };
+
+  /// Start of the tick in microseconds since boot
+  uint32_t timestamp = 0;
+  /// Actuation step duration in CPU cycles (nanoseconds on the host)
+  uint32_t actuation_cycles = 0;
+  /// MissionControlData::speed and rotation_angle, fixed point
+  int16_t command_speed  = 0;
+  int16_t command_angle  = 0;
+  uint8_t is_operational = 0;
+  char command_mode      = 'S';
+  /// RoverDriveSystem::GetCurrentMode()
+  char current_mode = 'S';
+  uint8_t flags     = 0;
+  WheelRecord left;
+  WheelRecord right;
+  WheelRecord back;
+};
+// Same layout on the rover and the host, no padding
+static_assert(sizeof(FlightRecord) == 40);
+
+/// 5.12 seconds of 10ms ticks in 20kB
+using DriveFlightRecorder = common::FlightRecorder<FlightRecord, 512>;
+
+/// Writes the column names of WriteFlightRecordCsv()
+inline void WriteFlightRecordCsvHeader(FILE * file)
+{
+  fprintf(file,
+          "time_s,actuation_cycles,is_operational,command_mode,"
+          "command_speed_rpm,command_angle_deg,current_mode,command_stale,"
+          "homing,switching");
+  for (const char * wheel : { "left", "right", "back" })
+  {
+    fprintf(file,
+            ",%s_speed_rpm,%s_angle_deg,%s_measured_speed_rpm,"
+            "%s_measured_angle_deg",
+            wheel, wheel, wheel, wheel);
+  }
+  fprintf(file, "\n");
+}
+
+/// Writes one record as a CSV row in physical units
+inline void WriteFlightRecordCsv(FILE * file, const FlightRecord & record)
+{
+  using protocol::FromFixed;
+  using protocol::kAngleScale;
+  using protocol::kSpeedScale;
+
+  fprintf(file, "%.6f,%lu,%u,%c,%.2f,%.1f,%c,%d,%d,%d",
+          record.timestamp / 1e6,
+          static_cast<unsigned long>(record.actuation_cycles),
+          static_cast<unsigned>(record.is_operational), record.command_mode,
+          FromFixed(record.command_speed, kSpeedScale),
+          FromFixed(record.command_angle, kAngleScale), record.current_mode,
+          (record.flags & FlightRecord::kCommandStale) != 0,
+          (record.flags & FlightRecord::kHoming) != 0,
+          (record.flags & FlightRecord::kSwitching) != 0);
+  for (const WheelRecord * wheel :
+       { &record.left, &record.right, &record.back })
+  {
+    fprintf(file, ",%.2f,%.1f,%.2f,%.1f",
+            FromFixed(wheel->commanded_speed, kSpeedScale),
+            FromFixed(wheel->commanded_angle, kAngleScale),
+            FromFixed(wheel->measured_speed, kSpeedScale),
+            FromFixed(wheel->measured_angle, kAngleScale));
+  }
+  fprintf(file, "\n");
+}
+}  // namespace sjsu::drive
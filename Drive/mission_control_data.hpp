@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "../Common/json_reader.hpp"
+
+namespace sjsu::drive
+{
+/// Drive commands received from mission control
+struct MissionControlData
+{
+  int is_operational = 0;
+  /// D = Drive, S = Spin, T = Translation, V = Velocity
+  char drive_mode = 'S';
+  /// Steering angle in degrees. In velocity mode this is instead the turn
+  /// rate of the rover in degrees per second, positive to the right.
+  float rotation_angle = 0.0f;
+  /// Hub speed in rpm. In velocity mode this is the forward speed of the
+  /// rover, given as the hub speed that drives it. There is no sideways
+  /// speed, so velocity mode never strafes (BodyVelocity::vy stays 0); use
+  /// translation mode for that.
+  float speed = 0.0f;
+};
+
+/// Bit flags for the MissionControlData fields found in a response
+enum MissionControlField : uint8_t
+{
+  kIsOperationalField = 1 << 0,
+  kDriveModeField     = 1 << 1,
+  kSpeedField         = 1 << 2,
+  kAngleField         = 1 << 3,
+  kAllFields          = kIsOperationalField | kDriveModeField | kSpeedField |
+               kAngleField,
+};
+
+/// Reads is_operational, drive_mode, speed and angle from a mission control
+/// JSON response in a single pass, in any order. Unknown keys are ignored.
+/// Only the fields that are present and valid are written to data, so a
+/// partial response never leaves a field half updated.
+/// @param json response body i.e. {"is_operational": 1, "drive_mode": "D"...}
+/// @param data commands to update
+/// @return MissionControlField flags of the fields that were updated
+inline uint8_t ParseMissionControlData(std::string_view json,
+                                       MissionControlData & data)
+{
+  uint8_t fields = 0;
+  common::JsonReader reader(json);
+  while (reader.Next())
+  {
+    std::string_view key           = reader.GetKey();
+    const common::JsonValue & value = reader.GetValue();
+
+    if (key == "is_operational")
+    {
+      bool is_operational;
+      if (value.ToBoolean(is_operational))
+      {
+        data.is_operational = is_operational;
+        fields |= kIsOperationalField;
+      }
+    }
+    else if (key == "drive_mode")
+    {
+      if (value.type == common::JsonValue::Type::kString &&
+          value.text.size() == 1)
+      {
+        data.drive_mode = value.text.front();
+        fields |= kDriveModeField;
+      }
+    }
+    else if (key == "speed")
+    {
+      if (value.ToFloat(data.speed))
+      {
+        fields |= kSpeedField;
+      }
+    }
+    else if (key == "angle")
+    {
+      if (value.ToFloat(data.rotation_angle))
+      {
+        fields |= kAngleField;
+      }
+    }
+  }
+  return fields;
+}
+}  // namespace sjsu::drive
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "peripherals/lpc40xx/can.hpp"
+#include "utility/log.hpp"
+#include "utility/math/units.hpp"
+#include "utility/time/time.hpp"
+
+namespace sjsu::drive
+{
+/// Latest measured state of one RMD-X motor, at the output shaft (after the
+/// gear ratio).
+struct MotorFeedback
+{
+  units::angular_velocity::revolutions_per_minute_t speed = 0_rpm;
+  /// Multi-turn angle since the motor powered on
+  units::angle::degree_t angle              = 0_deg;
+  units::current::ampere_t current          = {};
+  units::temperature::celsius_t temperature = {};
+  /// Uptime of the last speed/current/temperature reply
+  std::chrono::nanoseconds status_updated_at = 0ns;
+  /// Uptime of the last multi-turn angle reply
+  std::chrono::nanoseconds angle_updated_at = 0ns;
+  uint32_t status_replies                   = 0;
+  uint32_t angle_replies                    = 0;
+
+  bool HasStatus() const
+  {
+    return status_replies != 0;
+  }
+
+  bool HasAngle() const
+  {
+    return angle_replies != 0;
+  }
+};
+
+/// MotorFeedbackCache keeps the latest measured state of a set of RMD-X motors
+/// without ever waiting on the bus. Each Update() sends one feedback request,
+/// cycling through every motor and request type, and decodes whatever replies
+/// have arrived since the last Update(). Speed commands (0xA2) and position
+/// commands (0xA4) are answered with the same status reply, so commanded
+/// motors refresh even faster.
+///
+/// The cache reads the CAN peripheral directly, so it must be the only
+/// reader of its bus (don't also call CanNetwork::Update()). Update() and the
+/// getters must be called from the same task.
+template <size_t kMotorCount>
+class MotorFeedbackCache
+{
+ public:
+  /// Reads temperature, current, speed and encoder position
+  static constexpr uint8_t kReadStatus2Command = 0x9C;
+  /// Reads the multi-turn angle in 0.01 degrees
+  static constexpr uint8_t kReadMultiTurnCommand = 0x92;
+  static constexpr uint8_t kSpeedCommand         = 0xA2;
+  static constexpr uint8_t kPositionCommand      = 0xA4;
+  /// Torque current range of +/-2048 maps to +/-33A
+  static constexpr float kAmpsPerCurrentUnit = 33.0f / 2048.0f;
+  static constexpr size_t kRequestsPerMotor  = 2;
+
+  struct Motor_t
+  {
+    uint32_t id;
+    float gear_ratio;
+  };
+
+  MotorFeedbackCache(sjsu::CanNetwork & network,
+                     const std::array<Motor_t, kMotorCount> & motors)
+      : network_(network), motors_(motors)
+  {
+  }
+
+  /// Decodes all pending replies and sends the next feedback request. Call
+  /// once per control cycle; each motor is refreshed every
+  /// kMotorCount * kRequestsPerMotor updates.
+  void Update()
+  {
+    sjsu::Can & can = network_.GetCan();
+    while (can.HasData())
+    {
+      Decode(can.Receive());
+    }
+    SendNextRequest();
+  }
+
+  /// Decodes one reply, replies from motors not in the cache are ignored.
+  /// @return true if the reply updated a motor
+  bool Decode(const sjsu::Can::Message_t & message)
+  {
+    size_t index = IndexOf(message.id);
+    if (index == kMotorCount || message.length < 8)
+    {
+      return false;
+    }
+    const auto & data        = message.payload;
+    MotorFeedback & feedback = feedback_[index];
+    float gear_ratio         = motors_[index].gear_ratio;
+
+    switch (data[0])
+    {
+      case kReadStatus2Command:
+      case kSpeedCommand:
+      case kPositionCommand:
+      {
+        auto temperature = static_cast<int8_t>(data[1]);
+        auto current     = static_cast<int16_t>(data[2] | (data[3] << 8));
+        // Speed is in degrees per second at the motor shaft
+        auto speed = static_cast<int16_t>(data[4] | (data[5] << 8));
+        feedback.temperature = units::temperature::celsius_t(temperature);
+        feedback.current =
+            units::current::ampere_t(current * kAmpsPerCurrentUnit);
+        feedback.speed = units::angular_velocity::revolutions_per_minute_t(
+            speed / 6.0f / gear_ratio);
+        feedback.status_updated_at = sjsu::Uptime();
+        feedback.status_replies++;
+        break;
+      }
+      case kReadMultiTurnCommand:
+      {
+        // 56-bit signed angle in 0.01 degrees at the motor shaft
+        uint64_t raw = 0;
+        for (size_t i = 7; i >= 1; i--)
+        {
+          raw = (raw << 8) | data[i];
+        }
+        int64_t angle = static_cast<int64_t>(raw << 8) >> 8;
+        feedback.angle =
+            units::angle::degree_t(static_cast<float>(angle) / 100.0f /
+                                   gear_ratio);
+        feedback.angle_updated_at = sjsu::Uptime();
+        feedback.angle_replies++;
+        break;
+      }
+      default: return false;
+    }
+    return true;
+  }
+
+  /// @param id CAN id of the motor, i.e. 0x141
+  /// @return latest feedback of the motor, nullptr if it isn't in the cache
+  const MotorFeedback * GetFeedback(uint32_t id) const
+  {
+    size_t index = IndexOf(id);
+    return (index == kMotorCount) ? nullptr : &feedback_[index];
+  }
+
+  /// @return number of feedback requests sent
+  uint32_t GetRequestCount() const
+  {
+    return request_count_;
+  }
+
+ private:
+  size_t IndexOf(uint32_t id) const
+  {
+    for (size_t i = 0; i < kMotorCount; i++)
+    {
+      if (motors_[i].id == id)
+      {
+        return i;
+      }
+    }
+    return kMotorCount;
+  }
+
+  /// Staggers requests so only one feedback frame is on the bus per update
+  void SendNextRequest()
+  {
+    size_t slot  = request_count_ % (kMotorCount * kRequestsPerMotor);
+    size_t index = slot / kRequestsPerMotor;
+
+    sjsu::Can::Message_t message;
+    message.id                = motors_[index].id;
+    message.format            = sjsu::Can::Message_t::Format::kStandard;
+    message.is_remote_request = false;
+    message.length            = 8;
+    message.payload           = {};
+    message.payload[0]        = (slot % kRequestsPerMotor == 0)
+                                    ? kReadStatus2Command
+                                    : kReadMultiTurnCommand;
+    network_.GetCan().Send(message);
+    request_count_++;
+  }
+
+  sjsu::CanNetwork & network_;
+  std::array<Motor_t, kMotorCount> motors_;
+  std::array<MotorFeedback, kMotorCount> feedback_ = {};
+  uint32_t request_count_                          = 0;
+};
+}  // namespace sjsu::drive
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/log.hpp"
+#include "utility/math/units.hpp"
+
+namespace sjsu::drive
+{
+/// MotorGroup commands several RMD-X motors together so they start moving at
+/// the same instant. When every motor gets the same command it is sent once
+/// as an RMD-X multi-motor (0x280) frame, which every motor on the bus acts on
+/// at the same time. Otherwise the commands are sent back to back, one frame
+/// per motor, with nothing in between to add skew.
+///
+/// The multi-motor frame reaches EVERY RMD-X on the bus, not only the motors
+/// in the group, so broadcasting is off unless settings.use_broadcast is set.
+/// Only set it when the group's motors are alone on their CAN bus.
+template <size_t kMotorCount>
+class MotorGroup
+{
+ public:
+  static constexpr uint32_t kMultiMotorId   = 0x280;
+  static constexpr uint8_t kSpeedCommand    = 0xA2;
+  static constexpr uint8_t kPositionCommand = 0xA4;
+
+  using Speeds = std::array<units::angular_velocity::revolutions_per_minute_t,
+                            kMotorCount>;
+  using Angles = std::array<units::angle::degree_t, kMotorCount>;
+
+  struct Settings_t
+  {
+    /// Send identical commands as one multi-motor frame
+    bool use_broadcast = false;
+  };
+
+  MotorGroup(sjsu::CanNetwork & network,
+             std::array<sjsu::RmdX *, kMotorCount> motors)
+      : network_(network), motors_(motors)
+  {
+  }
+
+  /// Sets every motor to the same speed
+  void SetSpeed(units::angular_velocity::revolutions_per_minute_t speed)
+  {
+    Speeds speeds;
+    speeds.fill(speed);
+    SetSpeed(speeds);
+  }
+
+  /// Sets the speed of each motor, in the order the motors were given
+  void SetSpeed(const Speeds & speeds)
+  {
+    if (CanBroadcast(speeds))
+    {
+      Broadcast(EncodeSpeed(speeds[0], motors_[0]->settings.gear_ratio));
+      return;
+    }
+    for (size_t i = 0; i < kMotorCount; i++)
+    {
+      motors_[i]->SetSpeed(speeds[i]);
+    }
+    individual_frames_ += kMotorCount;
+  }
+
+  /// Moves each motor to an absolute angle, in the order the motors were given
+  /// @param angles target angle of each motor's output shaft
+  /// @param max_speed speed limit while moving to the angle
+  void SetAngle(const Angles & angles,
+                units::angular_velocity::revolutions_per_minute_t max_speed)
+  {
+    if (CanBroadcast(angles))
+    {
+      Broadcast(EncodePosition(angles[0], max_speed,
+                               motors_[0]->settings.gear_ratio));
+      return;
+    }
+    for (size_t i = 0; i < kMotorCount; i++)
+    {
+      motors_[i]->SetAngle(angles[i], max_speed);
+    }
+    individual_frames_ += kMotorCount;
+  }
+
+  /// @return number of multi-motor frames sent
+  uint32_t GetBroadcastFrames() const
+  {
+    return broadcast_frames_;
+  }
+
+  /// @return number of single motor frames sent
+  uint32_t GetIndividualFrames() const
+  {
+    return individual_frames_;
+  }
+
+  /// Encodes a speed command (0xA2) the same way sjsu::RmdX does: 0.01 dps
+  /// per LSB at the motor shaft.
+  static std::array<uint8_t, 8> EncodeSpeed(
+      units::angular_velocity::revolutions_per_minute_t speed,
+      float gear_ratio)
+  {
+    // 1 rpm = 6 degrees per second
+    auto speed_data =
+        static_cast<int32_t>(speed.to<float>() * 6.0f * gear_ratio * 100.0f);
+    return {
+      kSpeedCommand,
+      0,
+      0,
+      0,
+      static_cast<uint8_t>(speed_data),
+      static_cast<uint8_t>(speed_data >> 8),
+      static_cast<uint8_t>(speed_data >> 16),
+      static_cast<uint8_t>(speed_data >> 24),
+    };
+  }
+
+  /// Encodes a position command (0xA4) the same way sjsu::RmdX does: 0.01
+  /// degrees per LSB and a max speed in degrees per second at the motor shaft.
+  static std::array<uint8_t, 8> EncodePosition(
+      units::angle::degree_t angle,
+      units::angular_velocity::revolutions_per_minute_t max_speed,
+      float gear_ratio)
+  {
+    auto angle_data =
+        static_cast<int32_t>(angle.to<float>() * gear_ratio * 100.0f);
+    auto speed_data =
+        static_cast<uint16_t>(max_speed.to<float>() * 6.0f * gear_ratio);
+    return {
+      kPositionCommand,
+      0,
+      static_cast<uint8_t>(speed_data),
+      static_cast<uint8_t>(speed_data >> 8),
+      static_cast<uint8_t>(angle_data),
+      static_cast<uint8_t>(angle_data >> 8),
+      static_cast<uint8_t>(angle_data >> 16),
+      static_cast<uint8_t>(angle_data >> 24),
+    };
+  }
+
+  Settings_t settings;
+
+ private:
+  /// A multi-motor frame carries one command, so every motor must get the
+  /// same value and scale it by the same gear ratio.
+  template <typename Values>
+  bool CanBroadcast(const Values & values) const
+  {
+    if (!settings.use_broadcast)
+    {
+      return false;
+    }
+    for (size_t i = 1; i < kMotorCount; i++)
+    {
+      if (values[i] != values[0] ||
+          motors_[i]->settings.gear_ratio != motors_[0]->settings.gear_ratio)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Broadcast(const std::array<uint8_t, 8> & payload)
+  {
+    sjsu::Can::Message_t message;
+    message.id                = kMultiMotorId;
+    message.format            = sjsu::Can::Message_t::Format::kStandard;
+    message.is_remote_request = false;
+    message.length            = payload.size();
+    message.payload           = payload;
+    network_.GetCan().Send(message);
+    broadcast_frames_++;
+  }
+
+  sjsu::CanNetwork & network_;
+  std::array<sjsu::RmdX *, kMotorCount> motors_;
+  uint32_t broadcast_frames_  = 0;
+  uint32_t individual_frames_ = 0;
+};
+}  // namespace sjsu::drive
@@ -1,3 +1,26 @@
 TESTS += test/rover_drive_system_test.cpp
 TESTS += test/wheel_test.cpp
-# TESTS += test/esp_test.cpp
\ No newline at end of file
+TESTS += test/request_writer_test.cpp
+TESTS += test/http_response_parser_test.cpp
+TESTS += test/json_reader_test.cpp
+TESTS += test/drive_protocol_test.cpp
+TESTS += test/mailbox_test.cpp
+TESTS += test/periodic_executive_test.cpp
+TESTS += test/motor_group_test.cpp
+TESTS += test/motor_feedback_test.cpp
+TESTS += test/speed_ramp_test.cpp
+TESTS += test/swerve_kinematics_test.cpp
+TESTS += test/cycle_counter_test.cpp
+TESTS += test/rmd_x_simulator_test.cpp
+TESTS += test/deferred_log_test.cpp
+TESTS += test/flight_recorder_test.cpp
+TESTS += test/wifi_link_test.cpp
+TESTS += test/telemetry_delta_test.cpp
+TESTS += test/ring_uart_test.cpp
+TESTS += test/mission_control_exchange_test.cpp
+TESTS += test/esp_test.cpp
+TESTS += test/drive_tasks_test.cpp
+BENCHMARKS += benchmark/json_parse_benchmark.cpp
+DRIVE_BENCHMARKS += benchmark/control_math_benchmark.cpp
+DRIVE_BENCHMARKS += benchmark/drive_tick_benchmark.cpp
+TOOLS += tools/flight_recorder_csv.cpp
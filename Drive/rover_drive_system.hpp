@@ -1,13 +1,19 @@
 #pragma once
 
-#include <stdio.h>
-
 #include "utility/log.hpp"
 #include "utility/time/time.hpp"
 #include "utility/math/units.hpp"
 #include "utility/math/map.hpp"
 
+#include "../Common/deferred_log.hpp"
 #include "../Common/esp.hpp"
+#include "../Common/status.hpp"
+#include "drive_protocol.hpp"
+#include "flight_record.hpp"
+#include "mission_control_data.hpp"
+#include "motor_group.hpp"
+#include "speed_ramp.hpp"
+#include "swerve_kinematics.hpp"
 #include "wheel.hpp"
 
 namespace sjsu::drive
@@ -15,12 +21,31 @@ namespace sjsu::drive
 class RoverDriveSystem
 {
  public:
-  struct MissionControlData
-  {
-    int is_operational;
-    char drive_mode;
-    float rotation_angle;
-    float speed;
+  using MissionControlData = drive::MissionControlData;
+  /// Hub motors of the left, right and back wheels, in that order
+  using HubMotorGroup = MotorGroup<3>;
+  using Kinematics    = SwerveKinematics<3>;
+
+  /// Mission control endpoint commands are requested from
+  static constexpr std::string_view kEndpoint =
+      "Vishnu-Adda/json-robo-test/drive";
+
+  /// Leg length from the center of the rover to each steering axis. Not
+  /// measured yet, see SetGeometry().
+  static constexpr float kLegLength = 0.5f;
+  /// Radius of the hub wheels. Not measured yet, see SetGeometry().
+  static constexpr float kWheelRadius = 0.1f;
+  /// The left and right legs point 45 degrees off forward and the back leg
+  /// points straight back. At home each wheel is perpendicular to its leg and
+  /// rolls clockwise around the center with a positive hub speed. Only the
+  /// layout is right, the dimensions are placeholders.
+  static constexpr SwerveGeometry<3> kGeometry = {
+    .wheels       = { { { kLegLength * 0.70710678f, kLegLength * 0.70710678f,
+                          -45.0f },
+                        { kLegLength * 0.70710678f, -kLegLength * 0.70710678f,
+                          -135.0f },
+                        { -kLegLength, 0.0f, 90.0f } } },
+    .wheel_radius = kWheelRadius,
   };
 
   RoverDriveSystem(Wheel & left_wheel, Wheel & right_wheel, Wheel & back_wheel)
@@ -33,154 +58,366 @@ class RoverDriveSystem
     return current_mode_;
   }
 
-  /// Initializes wheels and sets rover to operational starting mode (spin)
+  /// Sends wheel speeds to all hub motors together through the group instead
+  /// of one wheel at a time.
+  /// @param hub_motors group of the left, right and back hub motors
+  void SetHubMotorGroup(HubMotorGroup & hub_motors)
+  {
+    hub_motors_ = &hub_motors;
+  }
+
+  /// Initializes wheels and sets rover to operational starting mode (spin).
+  /// Wheels start homing in the background, HandleRoverMovement() finishes
+  /// homing before moving the rover.
   void Initialize()
   {
-    try
-    {
-      mc_data.is_operational = true;
-      left_wheel_.Initialize();
-      right_wheel_.Initialize();
-      back_wheel_.Initialize();
-      HomeWheels();
-    }
-    catch (const std::exception & e)
+    mc_data.is_operational = true;
+    left_wheel_.Initialize();
+    right_wheel_.Initialize();
+    back_wheel_.Initialize();
+    StartHomingWheels();
+  };
+
+  /// Appends the GET request endpoint & parameters to the writer, i.e.
+  /// drive?is_operational=1&drive_mode=S... Speeds and angles are written to
+  /// the hundredths place. Does not allocate.
+  /// @param writer request being built, usually from Esp::NewGETRequest()
+  void CreateRequestParameters(common::RequestWriter & writer)
+  {
+    WriteRequestParameters(writer, GetTelemetry());
+  };
+
+  /// Appends a telemetry snapshot as GET request endpoint & parameters. Lets
+  /// a task that does not own the drive system build the request.
+  /// @param writer request being built, usually from Esp::NewGETRequest()
+  /// @param telemetry snapshot from GetTelemetry()
+  static void WriteRequestParameters(
+      common::RequestWriter & writer,
+      const protocol::DriveTelemetry & telemetry)
+  {
+    writer.Append(kEndpoint)
+        .AppendParameter("is_operational", telemetry.is_operational)
+        .AppendParameter("drive_mode", telemetry.drive_mode)
+        .AppendParameter("battery", telemetry.battery)
+        .AppendParameter("left_wheel_speed", telemetry.left.speed)
+        .AppendParameter("left_wheel_angle", telemetry.left.angle)
+        .AppendParameter("right_wheel_speed", telemetry.right.speed)
+        .AppendParameter("right_wheel_angle", telemetry.right.angle)
+        .AppendParameter("back_wheel_speed", telemetry.back.speed)
+        .AppendParameter("back_wheel_angle", telemetry.back.angle);
+  }
+
+  /// Parses GET response body and assigns it to rover variables. Fields may
+  /// be in any order, unknown fields are ignored and fields that are missing
+  /// keep their previous value.
+  /// @param response JSON response body
+  /// @return MissionControlField flags of the fields that were found
+  uint8_t ParseJSONResponse(std::string_view response)
+  {
+    uint8_t fields = ParseMissionControlData(response, mc_data);
+    if (fields != kAllFields)
     {
-      sjsu::LogError("Error initializing!");
-      throw e;
+      sjsu::LogWarning("Response missing fields (found 0x%X)!", fields);
     }
+
+    common::DeferLogInfo("is_operational: %d", mc_data.is_operational);
+    common::DeferLogInfo("drive_mode: %c", mc_data.drive_mode);
+    common::DeferLogInfo("speed: %f", mc_data.speed);
+    common::DeferLogInfo("rotation_angle: %f", mc_data.rotation_angle);
+    return fields;
   };
 
-  /// Constructs GET request parameter
-  /// @return requestParameters endpoint & parameters i.e. /drive?ex=param
-  std::string CreateRequestParameters()
+  /// @return the current state of the rover as reported to mission control
+  protocol::DriveTelemetry GetTelemetry()
+  {
+    protocol::DriveTelemetry telemetry;
+    telemetry.is_operational = mc_data.is_operational;
+    telemetry.drive_mode     = current_mode_;
+    telemetry.battery        = state_of_charge_;
+
+    telemetry.left  = GetWheelTelemetry(left_wheel_);
+    telemetry.right = GetWheelTelemetry(right_wheel_);
+    telemetry.back  = GetWheelTelemetry(back_wheel_);
+    return telemetry;
+  }
+
+  /// @return the commands, mode and wheel states for the flight recorder.
+  ///         The actuation task fills in the timing and staleness.
+  FlightRecord GetFlightRecord()
   {
-    try
+    using protocol::kAngleScale;
+    using protocol::kSpeedScale;
+    using protocol::ToFixed;
+
+    FlightRecord record;
+    record.command_speed  = ToFixed(mc_data.speed, kSpeedScale);
+    record.command_angle  = ToFixed(mc_data.rotation_angle, kAngleScale);
+    record.is_operational = static_cast<uint8_t>(mc_data.is_operational);
+    record.command_mode   = mc_data.drive_mode;
+    record.current_mode   = current_mode_;
+    if (homing_status_ == HomingStatus::kHoming)
     {
-      // TODO - make these floats go to hundredths place (i.e. 0.00)?
-      // Breaks unit test often since it never knows correct decimal value
-      char reqParam[250];
-      snprintf(reqParam, 300,
-               "Vishnu-Adda/json-robo-test/"
-               "drive?is_operational=%d&drive_mode=%c&battery=%d&left_wheel_"
-               "speed=%4g&left_wheel_angle=%4g&right_wheel_speed=%4g&right_"
-               "wheel_angle=%4g&back_wheel_speed=%4g&back_wheel_angle=%4g",
-               mc_data.is_operational, current_mode_, state_of_charge_,
-               left_wheel_.GetSpeed(), left_wheel_.GetPosition(),
-               right_wheel_.GetSpeed(), right_wheel_.GetPosition(),
-               back_wheel_.GetSpeed(), back_wheel_.GetPosition());
-      std::string requestParameter = reqParam;
-      return requestParameter;
+      record.flags |= FlightRecord::kHoming;
     }
-    catch (const std::exception & e)
+    if (is_switching_mode_)
     {
-      sjsu::LogError("Error constructing GET request parameter!");
-      throw e;
+      record.flags |= FlightRecord::kSwitching;
     }
-  };
+    record.left  = GetWheelRecord(left_wheel_);
+    record.right = GetWheelRecord(right_wheel_);
+    record.back  = GetWheelRecord(back_wheel_);
+    return record;
+  }
 
-  /// Parses GET response body and assigns it to rover variables
-  /// @param response JSON response body
-  void ParseJSONResponse(std::string_view response)
+  /// Binary protocol alternative to CreateRequestParameters(). Encodes the
+  /// same telemetry into a protocol::kTelemetryFrameSize byte frame.
+  /// @param frame buffer to encode the frame into
+  /// @return size of the frame, 0 if the buffer is too small
+  size_t CreateTelemetryFrame(std::span<uint8_t> frame)
   {
-    try
+    return protocol::EncodeTelemetryFrame(GetTelemetry(),
+                                          telemetry_sequence_++, frame);
+  }
+
+  /// Binary protocol alternative to ParseJSONResponse(). Frames that are
+  /// corrupt or older than the last accepted command are ignored. A restarted
+  /// mission control numbers its frames from 0 again, so a frame more than
+  /// kStaleSequences behind, or the first one after kSequenceTimeout without
+  /// any, starts the sequence over.
+  /// @param frame command frame received from mission control
+  /// @return true if mc_data was updated
+  bool ParseCommandFrame(std::span<const uint8_t> frame)
+  {
+    MissionControlData data;
+    uint16_t sequence;
+    protocol::FrameStatus status =
+        protocol::DecodeCommandFrame(frame, data, sequence);
+    if (status != protocol::FrameStatus::kOk)
     {
-      sscanf(
-          reinterpret_cast<const char *>(response.data()),
-          R"({ "is_operational": %d, "drive_mode": "%c", "speed": %f, "angle": %f }\n)",
-          &mc_data.is_operational, &mc_data.drive_mode, &mc_data.speed,
-          &mc_data.rotation_angle);
-
-      sjsu::LogInfo("is_operational: %d", mc_data.is_operational);
-      sjsu::LogInfo("drive_mode: %c", mc_data.drive_mode);
-      sjsu::LogInfo("speed: %f", mc_data.speed);
-      sjsu::LogInfo("rotation_angle: %f", mc_data.rotation_angle);
+      sjsu::LogError("Invalid command frame (%d)!", static_cast<int>(status));
+      return false;
     }
-    catch (const std::exception & e)
+    std::chrono::nanoseconds now = sjsu::Uptime();
+    bool is_restart =
+        !has_command_sequence_ ||
+        static_cast<uint16_t>(command_sequence_ - sequence) > kStaleSequences ||
+        now - command_received_ > kSequenceTimeout;
+    if (!is_restart && !protocol::IsNewerSequence(sequence, command_sequence_))
     {
-      sjsu::LogError("Error parsing GET response!");
-      throw e;
+      sjsu::LogWarning("Ignoring stale command frame %u",
+                       static_cast<unsigned>(sequence));
+      return false;
     }
-  };
+    has_command_sequence_ = true;
+    command_sequence_     = sequence;
+    command_received_     = now;
+    mc_data               = data;
+    return true;
+  }
 
   /// Handles the rover movement depending on the mode.
-  /// D = Drive, S = Spin, T = Translation
-  void HandleRoverMovement()
+  /// D = Drive, S = Spin, T = Translation, V = Velocity
+  /// Does not move the rover while the wheels are homing, or at all once the
+  /// homing failed, since the steering angles are relative to home.
+  /// @return Status::kOk, or why the rover could not move as commanded
+  common::Status HandleRoverMovement()
   {
-    try
+    // sjsu::LogInfo("is_operational: %d", mc_data.is_operational);
+    // sjsu::LogInfo("drive_mode: %c", mc_data.drive_mode);
+    // sjsu::LogInfo("speed: %f", mc_data.speed);
+    // sjsu::LogInfo("angle: %f", mc_data.rotation_angle);
+
+    if (homing_status_ == HomingStatus::kHoming)
     {
-      // sjsu::LogInfo("is_operational: %d", mc_data.is_operational);
-      // sjsu::LogInfo("drive_mode: %c", mc_data.drive_mode);
-      // sjsu::LogInfo("speed: %f", mc_data.speed);
-      // sjsu::LogInfo("angle: %f", mc_data.rotation_angle);
-
-      units::angle::degree_t angle(mc_data.rotation_angle);
-      units::angular_velocity::revolutions_per_minute_t speed(mc_data.speed);
-      // If current mode is same as mc mode value and rover is operational
-      if (mc_data.is_operational && (current_mode_ == mc_data.drive_mode))
-      {
-        sjsu::LogInfo("Handling %c movement...", current_mode_);
-        switch (current_mode_)
-        {
-          case 'D': HandleDriveMode(speed, angle); break;
-          case 'S': HandleSpinMode(speed); break;
-          case 'T': HandleTranslationMode(speed, angle); break;
-          default:
-            SetWheelSpeed(kZeroSpeed);
-            sjsu::LogError("Unable to assign drive mode handler!");
-            break;
-        }
-      }
-      else
+      return (UpdateHoming() == HomingStatus::kFailed)
+                 ? common::Status::kHomingFailed
+                 : common::Status::kOk;
+    }
+    if (homing_status_ == HomingStatus::kFailed)
+    {
+      SetWheelSpeed(kZeroSpeed);
+      return common::Status::kHomingFailed;
+    }
+
+    units::angle::degree_t angle(mc_data.rotation_angle);
+    units::angular_velocity::revolutions_per_minute_t speed(mc_data.speed);
+    // If current mode is same as mc mode value and rover is operational. A
+    // switch that was called off still has to steer back to the mode's angles
+    // through SetMode().
+    if (mc_data.is_operational && (current_mode_ == mc_data.drive_mode) &&
+        !is_switching_mode_)
+    {
+      common::DeferLogDebug("Handling %c movement...", current_mode_);
+      switch (current_mode_)
       {
-        // If current mode is not same as mc mode value
-        sjsu::LogInfo("Switching rover into %c mode...", mc_data.drive_mode);
-        SetMode();
+        case 'D': HandleDriveMode(speed, angle); break;
+        case 'S': HandleSpinMode(speed); break;
+        case 'T': HandleTranslationMode(speed, angle); break;
+        case 'V': HandleVelocityMode(speed, angle); break;
+        default: return RefuseMode("Unable to assign drive mode handler!");
       }
+      return common::Status::kOk;
     }
-    catch (const std::exception & e)
+    // If current mode is not same as mc mode value
+    common::DeferLogInfo("Switching rover into %c mode...", mc_data.drive_mode);
+    return SetMode();
+  };
+
+  /// HomeWheels all the wheels so the motors know their actual position.
+  /// The wheels home at the same time; blocks until all of them are done.
+  /// @return HomingStatus::kHomed if every wheel found its home mark
+  HomingStatus HomeWheels()
+  {
+    StartHomingWheels();
+    while (UpdateHoming() == HomingStatus::kHoming)
     {
-      sjsu::LogError("Error handling movement!");
-      throw e;
+      sjsu::Delay(kHomingPollPeriod);
     }
+    return homing_status_;
   };
 
-  /// HomeWheels all the wheels so the motors know their actual position.
-  /// @return true if successfully moves wheels into home position
-  void HomeWheels()
+  /// Stops the rover and starts homing all wheels at once without waiting.
+  /// Step the homing with UpdateHoming().
+  void StartHomingWheels()
   {
-    try
+    SetWheelSpeed(kZeroSpeed);
+    left_wheel_.StartHoming();
+    right_wheel_.StartHoming();
+    back_wheel_.StartHoming();
+    UpdateHoming();
+  }
+
+  /// Steps the homing of every wheel once. Never blocks.
+  /// @return kHoming while any wheel is homing, then kFailed if any wheel
+  ///         failed or kHomed if all wheels are home
+  HomingStatus UpdateHoming()
+  {
+    HomingStatus left  = left_wheel_.UpdateHoming();
+    HomingStatus right = right_wheel_.UpdateHoming();
+    HomingStatus back  = back_wheel_.UpdateHoming();
+
+    if (left == HomingStatus::kHoming || right == HomingStatus::kHoming ||
+        back == HomingStatus::kHoming)
     {
-      SetWheelSpeed(kZeroSpeed);
-      left_wheel_.HomeWheel();
-      right_wheel_.HomeWheel();
-      back_wheel_.HomeWheel();
+      homing_status_ = HomingStatus::kHoming;
     }
-    catch (const std::exception & e)
+    else if (left == HomingStatus::kHomed && right == HomingStatus::kHomed &&
+             back == HomingStatus::kHomed)
     {
-      sjsu::LogError("Error homing the wheels!");
-      throw e;
+      homing_status_ = HomingStatus::kHomed;
     }
-  };
+    else
+    {
+      homing_status_ = HomingStatus::kFailed;
+      sjsu::LogError("Homing failed (left %d, right %d, back %d)!",
+                     static_cast<int>(left), static_cast<int>(right),
+                     static_cast<int>(back));
+    }
+    return homing_status_;
+  }
+
+  HomingStatus GetHomingStatus() const
+  {
+    return homing_status_;
+  }
 
-  /// Sets all wheels to the speed provided. Wheel class handles max/min speeds
+  /// Sets all wheels to the speed provided. Wheel class handles max/min speeds.
+  /// With a speed ramp the wheels only reach the speed over the following
+  /// UpdateWheelSpeeds() calls.
   /// @param speed the new movement speed of the rover
   void SetWheelSpeed(units::angular_velocity::revolutions_per_minute_t speed)
   {
-    // TODO: Implement linear interpolation (exponential moving average) to
-    // smooth out changes in speed.
-    try
+    SetWheelSpeeds({ speed, speed, speed });
+  };
+
+  /// Sets each wheel to its own speed, like SetWheelSpeed()
+  /// @param speeds left, right and back wheel speeds
+  void SetWheelSpeeds(const HubMotorGroup::Speeds & speeds)
+  {
+    target_speeds_ = { left_wheel_.LimitHubSpeed(speeds[0]),
+                       right_wheel_.LimitHubSpeed(speeds[1]),
+                       back_wheel_.LimitHubSpeed(speeds[2]) };
+    if (!is_ramping_)
+    {
+      SendWheelSpeeds(target_speeds_);
+    }
+  }
+
+  /// Steers and drives every wheel so the rover body moves at the velocity,
+  /// see SwerveKinematics. Wheels are slowed down together to stay within
+  /// their speed limit, and wheels that would stand still keep their angle.
+  /// @param velocity desired velocity of the rover body
+  void SetBodyVelocity(const BodyVelocity & velocity)
+  {
+    units::angular_velocity::revolutions_per_minute_t max_speed =
+        std::min({ left_wheel_.GetMaxSpeed(), right_wheel_.GetMaxSpeed(),
+                   back_wheel_.GetMaxSpeed() });
+    Kinematics::Commands commands = kinematics_.Solve(velocity, max_speed);
+
+    for (size_t i = 0; i < commands.size(); i++)
     {
-      left_wheel_.SetHubSpeed(speed);
-      right_wheel_.SetHubSpeed(speed);
-      back_wheel_.SetHubSpeed(speed);
+      if (!Kinematics::IsStopped(commands[i]))
+      {
+        SteerWheel(i, commands[i].angle);
+      }
     }
-    catch (const std::exception & e)
+    SetWheelSpeeds(
+        { commands[0].speed, commands[1].speed, commands[2].speed });
+  }
+
+  /// Sets the wheel layout measured on the rover, which velocity mode needs
+  /// to turn its speeds and turn rates into wheel commands. Velocity mode is
+  /// refused until then, kGeometry only has placeholder dimensions.
+  /// @param geometry steering axis positions and wheel radius in meters
+  void SetGeometry(const SwerveGeometry<3> & geometry)
+  {
+    kinematics_   = Kinematics(geometry);
+    has_geometry_ = true;
+  }
+
+  /// Smooths every change of wheel speed with a jerk limited ramp from now on.
+  /// UpdateWheelSpeeds() must then be called once per control period.
+  /// @param limits acceleration and jerk limits of every wheel
+  /// @param control_period time between UpdateWheelSpeeds() calls
+  void SetSpeedRamp(const SpeedRamp::Limits_t & limits,
+                    std::chrono::nanoseconds control_period)
+  {
+    for (SpeedRamp & ramp : speed_ramps_)
     {
-      sjsu::LogError("Error setting wheels speed!");
-      throw e;
+      ramp.SetLimits(limits);
     }
-  };
+    control_period_ = control_period;
+    is_ramping_     = true;
+  }
+
+  /// Steps each wheel's speed ramp one control period towards the speed from
+  /// SetWheelSpeed(). Does nothing without a speed ramp.
+  void UpdateWheelSpeeds()
+  {
+    if (!is_ramping_)
+    {
+      return;
+    }
+    HubMotorGroup::Speeds speeds;
+    bool has_changed = false;
+    for (size_t i = 0; i < speeds.size(); i++)
+    {
+      speeds[i] = speed_ramps_[i].Update(target_speeds_[i], control_period_);
+      has_changed |= (speeds[i] != current_speeds_[i]);
+    }
+    // Holding a steady speed needs no bus traffic
+    if (has_changed)
+    {
+      SendWheelSpeeds(speeds);
+    }
+  }
+
+  /// @return true once every wheel has ramped down to a stop
+  bool AreWheelsStopped() const
+  {
+    return current_speeds_[0] == kZeroSpeed &&
+           current_speeds_[1] == kZeroSpeed && current_speeds_[2] == kZeroSpeed;
+  }
 
   /// Prints the speed and position/angle of each wheel on the rover
   void PrintRoverData()
@@ -197,28 +434,164 @@ class RoverDriveSystem
   };
 
  private:
-  /// Stops the rover and sets a new mode.
-  void SetMode()
+  /// Steering positions of the left, right and back wheels
+  struct ModeAngles
+  {
+    units::angle::degree_t left;
+    units::angle::degree_t right;
+    units::angle::degree_t back;
+  };
+
+  /// @return the left, right and back wheels, in the order of their speeds
+  std::array<Wheel *, 3> GetWheels()
+  {
+    return { &left_wheel_, &right_wheel_, &back_wheel_ };
+  }
+
+  /// Steers a wheel like Wheel::SetSteeringPosition(). When its hub flips,
+  /// the hub motor keeps turning the same way, so the wheel's speed carries
+  /// on from the opposite speed and ramps through zero back to the target
+  /// like any other speed change.
+  /// @param index position of the wheel in HubMotorGroup::Speeds
+  /// @param position angle relative to home
+  void SteerWheel(size_t index, units::angle::degree_t position)
+  {
+    Wheel & wheel     = *GetWheels()[index];
+    bool was_inverted = wheel.IsHubInverted();
+    wheel.SetSteeringPosition(position);
+    if (wheel.IsHubInverted() == was_inverted ||
+        current_speeds_[index] == kZeroSpeed)
+    {
+      return;
+    }
+    current_speeds_[index] = -current_speeds_[index];
+    speed_ramps_[index].Reverse();
+    if (!is_ramping_)
+    {
+      SendWheelSpeeds(target_speeds_);
+    }
+  }
+
+  /// Sends a speed to each hub motor right away
+  /// @param speeds left, right and back wheel speeds within the wheel limits
+  void SendWheelSpeeds(const HubMotorGroup::Speeds & speeds)
+  {
+    if (hub_motors_ != nullptr)
+    {
+      hub_motors_->SetSpeed({ left_wheel_.ToHubMotorSpeed(speeds[0]),
+                              right_wheel_.ToHubMotorSpeed(speeds[1]),
+                              back_wheel_.ToHubMotorSpeed(speeds[2]) });
+      left_wheel_.UpdateHubSpeed(speeds[0]);
+      right_wheel_.UpdateHubSpeed(speeds[1]);
+      back_wheel_.UpdateHubSpeed(speeds[2]);
+    }
+    else
+    {
+      left_wheel_.SetHubSpeed(speeds[0]);
+      right_wheel_.SetHubSpeed(speeds[1]);
+      back_wheel_.SetHubSpeed(speeds[2]);
+    }
+    current_speeds_ = speeds;
+  }
+
+  /// Measured values fall back to commanded ones without motor feedback
+  static protocol::WheelTelemetry GetWheelTelemetry(Wheel & wheel)
   {
-    try
+    return { wheel.GetMeasuredSpeed(), wheel.GetMeasuredPosition() };
+  }
+
+  static WheelRecord GetWheelRecord(Wheel & wheel)
+  {
+    using protocol::kAngleScale;
+    using protocol::kSpeedScale;
+    using protocol::ToFixed;
+
+    return { ToFixed(wheel.GetSpeed(), kSpeedScale),
+             ToFixed(wheel.GetPosition(), kAngleScale),
+             ToFixed(wheel.GetMeasuredSpeed(), kSpeedScale),
+             ToFixed(wheel.GetMeasuredPosition(), kAngleScale) };
+  }
+
+  /// Stops the rover, then moves every wheel towards the new mode's angles at
+  /// once. The mode switches as soon as every wheel measures within
+  /// kModeTolerance of its target, call again until GetCurrentMode() changes.
+  /// Velocity mode steers the wheels as it goes, so it switches right away,
+  /// but only once SetGeometry() has been called.
+  /// @return Status::kOk while switching or once switched
+  common::Status SetMode()
+  {
+    if (mc_data.drive_mode == 'V')
+    {
+      if (!has_geometry_)
+      {
+        return RefuseMode("Velocity mode needs the measured wheel geometry!");
+      }
+      is_switching_mode_ = false;
+      current_mode_      = 'V';
+      refused_mode_      = '\0';
+      return common::Status::kOk;
+    }
+
+    if (!is_switching_mode_ || target_mode_ != mc_data.drive_mode)
     {
       SetWheelSpeed(kZeroSpeed);  // Stops rover
-      // TODO - Add a 1 second delay?
+      // Only steer once the hubs have ramped down
+      if (!AreWheelsStopped())
+      {
+        return common::Status::kOk;
+      }
       switch (mc_data.drive_mode)
       {
         case 'D': SetDriveMode(); break;
         case 'S': SetSpinMode(); break;
         case 'T': SetTranslationMode(); break;
-        default: sjsu::LogError("Unable to set drive mode!");
+        default: return RefuseMode("Unable to set drive mode!");
       };
+      is_switching_mode_   = true;
+      refused_mode_        = '\0';
+      target_mode_         = mc_data.drive_mode;
+      mode_switch_started_ = sjsu::Uptime();
+    }
+
+    if (left_wheel_.IsSteeringSettled(kModeTolerance) &&
+        right_wheel_.IsSteeringSettled(kModeTolerance) &&
+        back_wheel_.IsSteeringSettled(kModeTolerance))
+    {
+      is_switching_mode_ = false;
+      current_mode_      = target_mode_;
+      common::DeferLogInfo(
+          "Switched to %c mode in %lldms", current_mode_,
+          static_cast<long long>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  sjsu::Uptime() - mode_switch_started_)
+                  .count()));
     }
-    catch (const std::exception & e)
+    else if (sjsu::Uptime() - mode_switch_started_ > kModeTimeout)
     {
-      sjsu::LogError("Error setting drive mode!");
-      throw e;
+      // Commands the wheels again on the next call
+      is_switching_mode_ = false;
+      common::DeferLogError("Wheels did not reach %c mode in time!",
+                            target_mode_);
+      return common::Status::kModeTimeout;
     }
+    return common::Status::kOk;
   };
 
+  /// Stops the rover for a mode it cannot drive in. Mission control keeps
+  /// sending the mode every cycle, so the reason is only logged when the
+  /// refused mode changes.
+  /// @param reason string literal, logged from the deferred log
+  common::Status RefuseMode(const char * reason)
+  {
+    SetWheelSpeed(kZeroSpeed);
+    if (refused_mode_ != mc_data.drive_mode)
+    {
+      refused_mode_ = mc_data.drive_mode;
+      common::DeferLogError("%s (mode %c)", reason, mc_data.drive_mode);
+    }
+    return common::Status::kInvalidMode;
+  }
+
   // ======================
   // = DRIVE MODE SETTERS =
   // ======================
@@ -226,123 +599,118 @@ class RoverDriveSystem
   /// Aligns rover wheels all in the same direction, facing forward
   void SetDriveMode()
   {
-    try
-    {
-      HomeWheels();
-      const units::angle::degree_t left_wheel_angle  = -45_deg;
-      const units::angle::degree_t right_wheel_angle = -135_deg;
-      const units::angle::degree_t back_wheel_angle  = 90_deg;
-      left_wheel_.SetSteeringAngle(left_wheel_angle);
-      right_wheel_.SetSteeringAngle(right_wheel_angle);
-      back_wheel_.SetSteeringAngle(back_wheel_angle);
-      current_mode_ = 'D';
-    }
-    catch (const std::exception & e)
-    {
-      sjsu::LogError("Error setting drive mode!");
-      throw e;
-    }
+    SetSteeringPositions(kDriveAngles);
   };
 
-  /// Aligns rover wheels perpendicular to their legs using homing slip ring
+  /// Aligns rover wheels perpendicular to their legs (home)
   void SetSpinMode()
   {
-    try
-    {
-      HomeWheels();
-      const units::angle::degree_t left_wheel_angle  = 0_deg;
-      const units::angle::degree_t right_wheel_angle = 0_deg;
-      const units::angle::degree_t back_wheel_angle  = 0_deg;
-      left_wheel_.SetSteeringAngle(left_wheel_angle);
-      right_wheel_.SetSteeringAngle(right_wheel_angle);
-      back_wheel_.SetSteeringAngle(back_wheel_angle);
-      current_mode_ = 'S';
-    }
-    catch (const std::exception & e)
-    {
-      sjsu::LogError("Error setting spin mode!");
-      throw e;
-    }
+    SetSteeringPositions(kSpinAngles);
   };
 
   /// Aligns rover wheel all in the same direction, facing towards the right
   void SetTranslationMode()
   {
-    try
-    {
-      HomeWheels();
-      const units::angle::degree_t left_wheel_angle  = 45_deg;
-      const units::angle::degree_t right_wheel_angle = -45_deg;
-      const units::angle::degree_t back_wheel_angle  = -180_deg;
-      left_wheel_.SetSteeringAngle(left_wheel_angle);
-      right_wheel_.SetSteeringAngle(right_wheel_angle);
-      back_wheel_.SetSteeringAngle(back_wheel_angle);
-      current_mode_ = 'T';
-    }
-    catch (const std::exception & e)
-    {
-      sjsu::LogError("Error setting translation mode!");
-      throw e;
-    }
+    SetSteeringPositions(kTranslationAngles);
   };
 
+  /// Steers every wheel to its position in a mode, turned by an angle
+  void SetSteeringPositions(const ModeAngles & angles,
+                            units::angle::degree_t angle = 0_deg)
+  {
+    SteerWheel(0, angles.left + angle);
+    SteerWheel(1, angles.right + angle);
+    SteerWheel(2, angles.back + angle);
+  }
+
   // =======================
   // = DRIVE MODE HANDLERS =
   // =======================
 
-  /// Handles drive mode. Adjusts only the rear wheel of the rover
+  /// Handles drive mode. Adjusts only the rear wheel of the rover. The angle
+  /// is from the mode's back wheel position, so the handler can run every
+  /// control cycle with the same command without turning the wheel further.
   void HandleDriveMode(units::angular_velocity::revolutions_per_minute_t speed,
                        units::angle::degree_t angle)
   {
-    try
-    {
-      back_wheel_.SetSteeringAngle(angle);
-      SetWheelSpeed(speed);
-    }
-    catch (const std::exception & e)
-    {
-      sjsu::LogError("Error handling drive mode!");
-      throw e;
-    }
+    SteerWheel(2, kDriveAngles.back + angle);
+    SetWheelSpeed(speed);
   };
 
   /// Handles spin mode. Adjusts only the speed (aka the spin direction)
   void HandleSpinMode(units::angular_velocity::revolutions_per_minute_t speed)
   {
-    try
-    {
-      SetWheelSpeed(speed);
-    }
-    catch (const std::exception & e)
-    {
-      sjsu::LogError("Error handling spin mode!");
-      throw e;
-    }
+    SetWheelSpeed(speed);
   };
 
-  /// Handles translation mode. Adjusts all the wheels, keeping them parallel
+  /// Handles translation mode. Turns all the wheels by the angle from the
+  /// mode's positions, keeping them parallel
   void HandleTranslationMode(
       units::angular_velocity::revolutions_per_minute_t speed,
       units::angle::degree_t angle)
   {
-    try
-    {
-      left_wheel_.SetSteeringAngle(angle);
-      right_wheel_.SetSteeringAngle(angle);
-      back_wheel_.SetSteeringAngle(angle);
-      SetWheelSpeed(speed);
-    }
-    catch (const std::exception & e)
-    {
-      sjsu::LogError("Error handling translation mode!");
-      throw e;
-    }
+    SetSteeringPositions(kTranslationAngles, angle);
+    SetWheelSpeed(speed);
+  };
+
+  /// Handles velocity mode. Drives forward while turning at the same time
+  /// along an arc, any combination works without stopping.
+  /// @param speed forward speed of the rover, as the hub speed it takes
+  /// @param turn_rate turn rate in degrees per second, positive to the right
+  void HandleVelocityMode(
+      units::angular_velocity::revolutions_per_minute_t speed,
+      units::angle::degree_t turn_rate)
+  {
+    BodyVelocity velocity;
+    velocity.vx    = kinematics_.ToGroundSpeed(speed);
+    velocity.omega = -turn_rate.to<float>() / kDegreesPerRadian;
+    SetBodyVelocity(velocity);
   };
 
   char current_mode_   = 'S';
   int state_of_charge_ = 90;  // TODO - hardcoded for now
+  uint16_t telemetry_sequence_ = 0;
+  uint16_t command_sequence_   = 0;
+  bool has_command_sequence_   = false;
+  HubMotorGroup * hub_motors_  = nullptr;
+  HomingStatus homing_status_  = HomingStatus::kIdle;
+
+  /// When the last command frame was accepted
+  std::chrono::nanoseconds command_received_ = 0ns;
+
+  Kinematics kinematics_ = Kinematics(kGeometry);
+  bool has_geometry_     = false;
+
+  /// Left, right and back wheel speeds
+  HubMotorGroup::Speeds target_speeds_  = {};
+  HubMotorGroup::Speeds current_speeds_ = {};
+  std::array<SpeedRamp, 3> speed_ramps_;
+  std::chrono::nanoseconds control_period_ = 10ms;
+  bool is_ramping_                         = false;
+
+  bool is_switching_mode_                       = false;
+  char target_mode_                             = 'S';
+  /// Last mode that was refused, '\0' once a mode is accepted
+  char refused_mode_                            = '\0';
+  std::chrono::nanoseconds mode_switch_started_ = 0ns;
+
+  /// Left, right and back wheel positions of each mode
+  const ModeAngles kDriveAngles       = { -45_deg, -135_deg, 90_deg };
+  const ModeAngles kSpinAngles        = { 0_deg, 0_deg, 0_deg };
+  const ModeAngles kTranslationAngles = { 45_deg, -45_deg, -180_deg };
 
   const units::angular_velocity::revolutions_per_minute_t kZeroSpeed = 0_rpm;
+  static constexpr std::chrono::nanoseconds kHomingPollPeriod = 1ms;
+  /// Steering error at which a wheel counts as aligned for a new mode
+  const units::angle::degree_t kModeTolerance = 2_deg;
+  /// The longest mode switch (180 degrees at 20rpm) takes 1.5s
+  static constexpr std::chrono::nanoseconds kModeTimeout = 3s;
+  static constexpr float kDegreesPerRadian                 = 57.2957795f;
+  /// Frames at most this far behind the last command are stale, ones
+  /// further behind come from a restarted mission control
+  static constexpr uint16_t kStaleSequences = 256;
+  /// Silence after which any command frame starts the sequence over
+  static constexpr std::chrono::nanoseconds kSequenceTimeout = 1s;
 
  public:
   MissionControlData mc_data;
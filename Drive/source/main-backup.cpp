@@ -39,26 +39,33 @@ int main(void)
 
   sjsu::LogInfo("Initializing wheels and esp...");
   esp.Initialize();
+  // Nothing else to do here until the WiFi is up
+  while (!esp.MaintainLink())
+  {
+  }
   left_wheel.Initialize();
   right_wheel.Initialize();
   back_wheel.Initialize();
 
   // Drive control loop
-  // 1. Drive sys creates GET request parameters - returns endpoint+params
-  // 2. Make GET request using esp - returns response body in string_view
+  // 1. Drive sys writes GET request endpoint+params into the esp's request
+  // 2. Make GET request using esp - copies response body into response_body
   // 3. Drive sys parses GET response
   // 4. Drive sys handles rover movement - may move or switch modes
 
-  std::string_view response = esp.GETRequest("drive");
-  sjsu::LogInfo("Response Body:\n%s", response.data());
+  std::array<char, 1024> response_body;
+  std::string_view response = esp.GETRequest("drive", response_body);
+  sjsu::LogInfo("Response Body:\n%.*s", static_cast<int>(response.size()),
+                response.data());
 
   // while (true)
   // {
   //   try
   //   {
-  //     std::string parameters    = drive_system.CreateRequestParameters();
-  //     std::string_view response = esp.GETRequest(parameters);
-  //     sjsu::LogInfo("Response Body:\n%s", response.data());
+  //     drive_system.CreateRequestParameters(esp.NewGETRequest());
+  //     std::string_view response = esp.SendGETRequest(response_body);
+  //     sjsu::LogInfo("Response Body:\n%.*s",
+  //                   static_cast<int>(response.size()), response.data());
   //     drive_system.ParseJSONResponse(response);
   //     drive_system.HandleRoverMovement();
   //     drive_system.PrintRoverData();
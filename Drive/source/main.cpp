@@ -1,73 +1,137 @@
 #include "peripherals/lpc40xx/can.hpp"
+#include "peripherals/lpc40xx/uart.hpp"
+#include "peripherals/interrupt.hpp"
 #include "devices/actuators/servo/rmd_x.hpp"
+#include "L3_Application/task_scheduler.hpp"
 #include "utility/math/units.hpp"
 #include "utility/log.hpp"
 
 #include "rover_drive_system.hpp"
+#include "drive_tasks.hpp"
+#include "motor_group.hpp"
 #include "wheel.hpp"
 #include "../../Common/esp.hpp"
+#include "../../Common/mailbox.hpp"
+#include "../../Common/mission_control_exchange.hpp"
+#include "../../Common/ring_uart.hpp"
 
 int main(void)
 {
   sjsu::LogInfo("Starting the rover drive system...");
-  sjsu::common::Esp esp;
-  sjsu::lpc40xx::Can & can = sjsu::lpc40xx::GetCan<2>();
-  sjsu::StaticMemoryResource<1024> memory_resource;
-  sjsu::CanNetwork can_network(can, &memory_resource);
+  // Everything is static since the scheduler reuses main's stack once started
+  // Responses are received into a ring by the UART3 interrupt, so they are
+  // not lost to FIFO overruns while the network task is preempted, and the
+  // task blocks in 1ms sleeps instead of spinning while it waits
+  using EspUart =
+      sjsu::common::RingUart<sjsu::common::Esp::kReceiveRingCapacity>;
+  static EspUart esp_uart(
+      sjsu::lpc40xx::GetUart<3>(), [] {
+        sjsu::InterruptController::GetPlatformController().Enable({
+            .id      = sjsu::lpc40xx::UART3_IRQn,
+            .handler = [] { esp_uart.OnReceiveInterrupt(); },
+        });
+        // Receive data available and character timeout interrupts
+        sjsu::lpc40xx::LPC_UART3->IER = sjsu::lpc40xx::LPC_UART3->IER | 1;
+      },
+      1ms, sjsu::common::TaskDelay);
+  static sjsu::common::Esp esp(esp_uart);
+  static sjsu::lpc40xx::Can & can = sjsu::lpc40xx::GetCan<2>();
+  static sjsu::StaticMemoryResource<1024> memory_resource;
+  static sjsu::CanNetwork can_network(can, &memory_resource);
 
   // rmd addresses 0x141 - 0x148 are available
-  sjsu::RmdX left_steer_motor(can_network, 0x141);
-  sjsu::RmdX left_hub_motor(can_network, 0x142);
-  sjsu::RmdX right_steer_motor(can_network, 0x143);
-  sjsu::RmdX right_hub_motor(can_network, 0x144);
-  sjsu::RmdX back_steer_motor(can_network, 0x145);
-  sjsu::RmdX back_hub_motor(can_network, 0x146);
+  static sjsu::RmdX left_steer_motor(can_network, 0x141);
+  static sjsu::RmdX left_hub_motor(can_network, 0x142);
+  static sjsu::RmdX right_steer_motor(can_network, 0x143);
+  static sjsu::RmdX right_hub_motor(can_network, 0x144);
+  static sjsu::RmdX back_steer_motor(can_network, 0x145);
+  static sjsu::RmdX back_hub_motor(can_network, 0x146);
 
-  left_steer_motor.settings.gear_ratio  = 8;
-  left_hub_motor.settings.gear_ratio    = 8;
-  right_steer_motor.settings.gear_ratio = 8;
-  right_hub_motor.settings.gear_ratio   = 8;
-  back_steer_motor.settings.gear_ratio  = 8;
-  back_hub_motor.settings.gear_ratio    = 8;
+  constexpr float kGearRatio            = 8;
+  left_steer_motor.settings.gear_ratio  = kGearRatio;
+  left_hub_motor.settings.gear_ratio    = kGearRatio;
+  right_steer_motor.settings.gear_ratio = kGearRatio;
+  right_hub_motor.settings.gear_ratio   = kGearRatio;
+  back_steer_motor.settings.gear_ratio  = kGearRatio;
+  back_hub_motor.settings.gear_ratio    = kGearRatio;
 
-  sjsu::drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+  // Polls every motor in the background so wheels report measured state
+  static sjsu::drive::DriveFeedbackCache feedback(
+      can_network, { { { 0x141, kGearRatio },
+                       { 0x142, kGearRatio },
+                       { 0x143, kGearRatio },
+                       { 0x144, kGearRatio },
+                       { 0x145, kGearRatio },
+                       { 0x146, kGearRatio } } });
 
-  left_wheel.SetHubSpeed(10_rpm);
-  // sjsu::drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
-  // sjsu::drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+  // All wheels read the default P1.30 slip ring input until each wheel's
+  // homing pin is wired separately
+  static sjsu::drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+  static sjsu::drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
+  static sjsu::drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+  left_wheel.SetFeedback(feedback.GetFeedback(0x142),
+                         feedback.GetFeedback(0x141));
+  right_wheel.SetFeedback(feedback.GetFeedback(0x144),
+                          feedback.GetFeedback(0x143));
+  back_wheel.SetFeedback(feedback.GetFeedback(0x146),
+                         feedback.GetFeedback(0x145));
 
-  // sjsu::drive::RoverDriveSystem drive_system(left_wheel, right_wheel,
-  //                                            back_wheel);
+  static sjsu::drive::RoverDriveSystem drive_system(left_wheel, right_wheel,
+                                                    back_wheel);
 
-  // sjsu::LogInfo("Initializing wheels and esp...");
-  // esp.Initialize();
-  // left_wheel.Initialize();
-  // right_wheel.Initialize();
-  // back_wheel.Initialize();
+  // Sends the hub speeds back to back. The steer motors share this bus, so
+  // the multi-motor broadcast (settings.use_broadcast) must stay off.
+  static sjsu::drive::RoverDriveSystem::HubMotorGroup hub_motors(
+      can_network, { &left_hub_motor, &right_hub_motor, &back_hub_motor });
+  drive_system.SetHubMotorGroup(hub_motors);
+  // Ease the hubs into every speed change to avoid current spikes
+  drive_system.SetSpeedRamp({ .acceleration = 200.0f, .jerk = 1000.0f },
+                            sjsu::drive::ActuationTask::kControlPeriod);
+  // Velocity mode is refused until the leg length and wheel radius measured
+  // on the rover are passed to drive_system.SetGeometry()
 
-  // Drive control loop
-  // 1. Drive sys creates GET request parameters - returns endpoint+params
-  // 2. Make GET request using esp - returns response body in string_view
-  // 3. Drive sys parses GET response
-  // 4. Drive sys handles rover movement - may move or switch modes
+  // Drive control pipeline
+  // Network task (low priority, as fast as the network allows):
+  //   1. Writes one GET request with the latest telemetry of every client
+  //      of the exchange. Drive is the only one on this board, so it goes
+  //      to the drive endpoint on its own.
+  //   2. Makes GET request using esp - copies response body into its buffer
+  //   3. Hands each client its part of the response, the drive client posts
+  //      it to the command mailbox
+  // Actuation task (high priority, fixed 10ms period):
+  //   4. Decodes motor feedback and requests the next motor's feedback
+  //   5. Takes the latest command and handles rover movement - may move or
+  //      switch modes. Stops the rover if commands stop arriving.
+  //   6. Posts the rover's measured state to the telemetry mailbox
+  static sjsu::drive::CommandMailbox commands;
+  static sjsu::drive::TelemetryMailbox telemetry;
+  static sjsu::drive::DriveClient drive_client(commands, telemetry);
+  static sjsu::common::MissionControlExchange exchange(esp);
+  exchange.AddClient(drive_client);
+  static sjsu::drive::NetworkTask network_task(exchange);
+  static sjsu::drive::ActuationTask actuation_task(drive_system, feedback,
+                                                   commands, telemetry);
+  // Prints log messages deferred by the other tasks whenever the CPU is idle
+  static sjsu::drive::LogTask log_task;
+  // Keeps the last 5s of control cycles, printed when a cycle fails
+  static sjsu::drive::DriveFlightRecorder flight_recorder;
+  actuation_task.SetFlightRecorder(flight_recorder);
+  log_task.SetFlightRecorder(flight_recorder);
+  static sjsu::rtos::TaskScheduler scheduler;
 
-  // while (true)
-  // {
-  //   try
-  //   {
-  //     std::string parameters    = drive_system.CreateRequestParameters();
-  //     std::string_view response = esp.GETRequest(parameters);
-  //     sjsu::LogInfo("Response Body:\n%s", response.data());
-  //     drive_system.ParseJSONResponse(response);
-  //     drive_system.HandleRoverMovement();
-  //     drive_system.PrintRoverData();
-  //   }
-  //   catch (const std::exception & e)
-  //   {
-  //     sjsu::LogError("Error in main()!");
-  //     throw e;
-  //   }
-  // }
+  scheduler.AddTask(&network_task);
+  scheduler.AddTask(&actuation_task);
+  scheduler.AddTask(&log_task);
+  // The network task blocks on the esp, it only needs a short yield. The
+  // actuation task paces itself to fixed 10ms deadlines and blocks in
+  // vTaskDelay between them, so it needs no extra delay. The log task
+  // catches up every 20ms, well before 64 deferred messages pile up.
+  network_task.SetDelayTime(1);
+  actuation_task.SetDelayTime(0);
+  log_task.SetDelayTime(20);
 
+  sjsu::LogInfo("Starting scheduler...");
+  scheduler.Start();
+  sjsu::LogInfo("This point should not be reached!");
   return 0;
 }
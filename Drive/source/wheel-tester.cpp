@@ -26,7 +26,7 @@ int main(void)
   {
     // steering motor demo
     demoWheel.Initialize();
-    double currPos = demoWheel.GetPosition();
+    float currPos = demoWheel.GetPosition();
     sjsu::LogInfo("Current Position(start): %d", currPos);
     // demoWheel.SetSteeringAngle(180_deg);
     demoWheel.HomeWheel();
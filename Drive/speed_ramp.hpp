@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "utility/math/units.hpp"
+
+namespace sjsu::drive
+{
+/// SpeedRamp moves a speed towards a target as fast as an acceleration limit
+/// and a jerk (rate of change of acceleration) limit allow. Stepped once per
+/// control period, it produces an S-shaped speed profile: acceleration builds
+/// up gradually, holds at its limit, then eases off so the speed arrives at
+/// the target without overshooting. Changing the target mid-ramp (i.e.
+/// reversing) first eases the current acceleration off, still within the
+/// limits. Keeps hub motors from drawing current spikes on sudden speed
+/// changes.
+class SpeedRamp
+{
+ public:
+  struct Limits_t
+  {
+    /// Largest acceleration in rpm per second
+    float acceleration = 200.0f;
+    /// Largest change of acceleration in rpm per second per second
+    float jerk = 1000.0f;
+  };
+
+  SpeedRamp() = default;
+
+  explicit SpeedRamp(const Limits_t & limits) : limits_(limits) {}
+
+  void SetLimits(const Limits_t & limits)
+  {
+    limits_ = limits;
+  }
+
+  const Limits_t & GetLimits() const
+  {
+    return limits_;
+  }
+
+  /// Steps the ramp forward by one period.
+  /// @param target speed to move towards
+  /// @param period time since the last update, usually the control period
+  /// @return the new speed
+  units::angular_velocity::revolutions_per_minute_t Update(
+      units::angular_velocity::revolutions_per_minute_t target,
+      std::chrono::nanoseconds period)
+  {
+    float dt = std::chrono::duration<float>(period).count();
+    if (dt <= 0.0f)
+    {
+      return GetSpeed();
+    }
+
+    float goal      = target.to<float>();
+    float error     = goal - speed_;
+    float direction = (error >= 0.0f) ? 1.0f : -1.0f;
+    float distance  = std::fabs(error);
+    float jerk_step = limits_.jerk * dt;
+
+    // Close enough to finish within one jerk step, which also settles the
+    // rounding left over by the search below
+    if (distance <= jerk_step * dt && std::fabs(acceleration_) <= jerk_step)
+    {
+      acceleration_ = error / dt;
+      speed_        = goal;
+      return GetSpeed();
+    }
+
+    // Pick the largest acceleration towards the target, within one jerk step
+    // of the current one, that can still be eased back to zero by the time
+    // the speed reaches the target.
+    float current  = acceleration_ * direction;
+    float low      = current - jerk_step;
+    float high =
+        std::max(std::min(current + jerk_step, limits_.acceleration), low);
+    float accepted = low;
+    if (SpeedChange(high, dt, jerk_step) <= distance)
+    {
+      accepted = high;
+    }
+    else if (SpeedChange(low, dt, jerk_step) <= distance)
+    {
+      for (int i = 0; i < kSearchSteps; i++)
+      {
+        float middle = (accepted + high) / 2.0f;
+        if (SpeedChange(middle, dt, jerk_step) <= distance)
+        {
+          accepted = middle;
+        }
+        else
+        {
+          high = middle;
+        }
+      }
+    }
+    acceleration_ = accepted * direction;
+
+    float next = speed_ + acceleration_ * dt;
+    // Reached or stepped past the target, land on it exactly
+    if ((goal - next) * error <= 0.0f)
+    {
+      acceleration_ = error / dt;
+      next          = goal;
+    }
+    speed_ = next;
+    return GetSpeed();
+  }
+
+  /// Jumps straight to a speed with no acceleration, i.e. after homing
+  void Reset(units::angular_velocity::revolutions_per_minute_t speed = 0_rpm)
+  {
+    speed_        = speed.to<float>();
+    acceleration_ = 0.0f;
+  }
+
+  /// Negates the speed and acceleration, i.e. when the wheel the ramp drives
+  /// turns around and its motor keeps going the same way
+  void Reverse()
+  {
+    speed_        = -speed_;
+    acceleration_ = -acceleration_;
+  }
+
+  units::angular_velocity::revolutions_per_minute_t GetSpeed() const
+  {
+    return units::angular_velocity::revolutions_per_minute_t(speed_);
+  }
+
+  /// @return acceleration in rpm per second
+  float GetAcceleration() const
+  {
+    return acceleration_;
+  }
+
+ private:
+  static constexpr int kSearchSteps = 12;
+
+  /// @return speed gained by accelerating at acceleration for one step then
+  ///         easing the acceleration to zero one jerk step at a time
+  static float SpeedChange(float acceleration, float dt, float jerk_step)
+  {
+    float easing_steps =
+        (acceleration > 0.0f) ? std::ceil(acceleration / jerk_step) - 1.0f : 0;
+    float easing = easing_steps * acceleration -
+                   jerk_step * easing_steps * (easing_steps + 1.0f) / 2.0f;
+    return (acceleration + easing) * dt;
+  }
+
+  Limits_t limits_;
+  float speed_        = 0.0f;
+  float acceleration_ = 0.0f;
+};
+}  // namespace sjsu::drive
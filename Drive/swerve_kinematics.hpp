@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "utility/math/units.hpp"
+
+#include "wheel.hpp"
+
+namespace sjsu::drive
+{
+/// Velocity of the rover body. x points forward, y points left and rotation
+/// is counter-clockwise when seen from above.
+struct BodyVelocity
+{
+  /// Forward speed in meters per second
+  float vx = 0.0f;
+  /// Leftward speed in meters per second
+  float vy = 0.0f;
+  /// Counter-clockwise turn rate in radians per second
+  float omega = 0.0f;
+};
+
+/// Where a wheel sits on the rover and which way it rolls at home
+struct WheelModule
+{
+  /// Position of the steering axis from the center of the rover in meters
+  float x = 0.0f;
+  float y = 0.0f;
+  /// Direction the wheel rolls with a positive hub speed while steered to
+  /// home, in degrees counter-clockwise from forward
+  float home_heading = 0.0f;
+};
+
+/// Wheel layout of a swerve rover, meant to be a compile time constant
+template <size_t kWheelCount>
+struct SwerveGeometry
+{
+  std::array<WheelModule, kWheelCount> wheels;
+  /// Radius of the hub wheels in meters
+  float wheel_radius = 0.0f;
+};
+
+/// Steering angle and hub speed of one wheel
+struct WheelCommand
+{
+  /// Steering angle relative to home, positive to the right (clockwise) like
+  /// Wheel::SetSteeringPosition()
+  units::angle::degree_t angle = 0_deg;
+  units::angular_velocity::revolutions_per_minute_t speed = 0_rpm;
+};
+
+/// SwerveKinematics turns a body velocity into the steering angle and hub
+/// speed of every wheel. Each wheel has to roll along the velocity of its
+/// own point of the body,
+///
+///     wheel velocity = (vx - omega * y, vy + omega * x)
+///
+/// so driving, strafing and turning blend into a single command and no wheel
+/// ever has to stop for a mode switch. If any wheel would exceed the speed
+/// limit, every wheel is slowed down by the same factor so the rover still
+/// follows the commanded path. Solve() only does arithmetic on the stack.
+template <size_t kWheelCount>
+class SwerveKinematics
+{
+ public:
+  using Commands = std::array<WheelCommand, kWheelCount>;
+
+  /// Wheels slower than this keep their steering angle, a wheel that is
+  /// barely moving has no meaningful direction
+  static constexpr float kStoppedSpeed = 1e-4f;  // meters per second
+
+  constexpr explicit SwerveKinematics(
+      const SwerveGeometry<kWheelCount> & geometry)
+      : geometry_(geometry)
+  {
+  }
+
+  /// @param velocity desired body velocity
+  /// @param max_speed fastest allowed hub speed
+  /// @return steering angle and hub speed of each wheel in geometry order. A
+  ///         stopped wheel gets a speed of 0 and an angle of 0, see
+  ///         IsStopped().
+  Commands Solve(const BodyVelocity & velocity,
+                 units::angular_velocity::revolutions_per_minute_t max_speed)
+      const
+  {
+    Commands commands;
+    float fastest = 0.0f;
+    for (size_t i = 0; i < kWheelCount; i++)
+    {
+      const WheelModule & wheel = geometry_.wheels[i];
+      float vx    = velocity.vx - velocity.omega * wheel.y;
+      float vy    = velocity.vy + velocity.omega * wheel.x;
+      float speed = std::sqrt(vx * vx + vy * vy);
+      if (speed < kStoppedSpeed)
+      {
+        commands[i] = {};
+        continue;
+      }
+
+      float heading = std::atan2(vy, vx) * kDegreesPerRadian;
+      // Steering angles grow clockwise while headings grow counter-clockwise
+      commands[i].angle =
+          Wheel::NormalizeAngle(
+              units::angle::degree_t(wheel.home_heading - heading));
+      units::angular_velocity::revolutions_per_minute_t wheel_speed =
+          ToWheelSpeed(speed);
+      commands[i].speed = wheel_speed;
+      fastest           = std::max(fastest, wheel_speed.to<float>());
+    }
+
+    float limit = max_speed.to<float>();
+    if (fastest > limit)
+    {
+      float scale = limit / fastest;
+      for (WheelCommand & command : commands)
+      {
+        command.speed = command.speed * scale;
+      }
+    }
+    return commands;
+  }
+
+  /// @return true if the command leaves the wheel where it is
+  static bool IsStopped(const WheelCommand & command)
+  {
+    return command.speed == 0_rpm;
+  }
+
+  /// @param speed hub speed
+  /// @return ground speed of a wheel in meters per second
+  constexpr float ToGroundSpeed(
+      units::angular_velocity::revolutions_per_minute_t speed) const
+  {
+    return speed.to<float>() * kRadiansPerRevolution / 60.0f *
+           geometry_.wheel_radius;
+  }
+
+  /// @param speed ground speed of a wheel in meters per second
+  /// @return hub speed
+  constexpr units::angular_velocity::revolutions_per_minute_t ToWheelSpeed(
+      float speed) const
+  {
+    return units::angular_velocity::revolutions_per_minute_t(
+        speed / geometry_.wheel_radius * 60.0f / kRadiansPerRevolution);
+  }
+
+  constexpr const SwerveGeometry<kWheelCount> & GetGeometry() const
+  {
+    return geometry_;
+  }
+
+ private:
+  static constexpr float kRadiansPerRevolution = 6.28318531f;
+  static constexpr float kDegreesPerRadian     = 57.2957795f;
+
+  SwerveGeometry<kWheelCount> geometry_;
+};
+}  // namespace sjsu::drive
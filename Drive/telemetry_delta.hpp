@@ -0,0 +1,302 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+
+#include "../Common/json_reader.hpp"
+#include "../Common/request_writer.hpp"
+#include "drive_protocol.hpp"
+
+namespace sjsu::drive
+{
+/// Bit flags for the telemetry query parameters
+enum TelemetryField : uint16_t
+{
+  kIsOperationalTelemetry = 1 << 0,
+  kDriveModeTelemetry     = 1 << 1,
+  kBatteryTelemetry       = 1 << 2,
+  kLeftSpeedTelemetry     = 1 << 3,
+  kLeftAngleTelemetry     = 1 << 4,
+  kRightSpeedTelemetry    = 1 << 5,
+  kRightAngleTelemetry    = 1 << 6,
+  kBackSpeedTelemetry     = 1 << 7,
+  kBackAngleTelemetry     = 1 << 8,
+  kAllTelemetry           = (1 << 9) - 1,
+};
+
+/// Smallest changes worth reporting to mission control
+struct TelemetryDeadband
+{
+  /// rpm
+  float speed = 0.5f;
+  /// degrees
+  float angle = 0.5f;
+};
+
+/// Query parameter names, in the order they are written
+inline constexpr std::array<std::string_view, 9> kTelemetryParameters = {
+  "is_operational",    "drive_mode",       "battery",
+  "left_wheel_speed",  "left_wheel_angle", "right_wheel_speed",
+  "right_wheel_angle", "back_wheel_speed", "back_wheel_angle",
+};
+
+/// Query parameter marking a request that carries every field
+inline constexpr std::string_view kKeyframeParameter = "keyframe";
+
+/// @return pointers to the wheel speeds and angles, in the order of
+///         kTelemetryParameters
+template <typename Telemetry>
+auto GetWheelFields(Telemetry & telemetry)
+{
+  return std::array{
+    &telemetry.left.speed,  &telemetry.left.angle, &telemetry.right.speed,
+    &telemetry.right.angle, &telemetry.back.speed, &telemetry.back.angle,
+  };
+}
+
+/// TelemetryDeltaEncoder writes the telemetry query parameters of a request
+/// like RoverDriveSystem::WriteRequestParameters(), but only the fields that
+/// changed by more than the deadband since the last request mission control
+/// acknowledged. Every keyframe_interval requests, and until the first
+/// acknowledgement, a keyframe with every field is sent instead.
+///
+/// Fields carry absolute values, so a request that is lost only delays its
+/// changes: they are sent again until a request carrying them is
+/// acknowledged. TelemetryDeltaDecoder rebuilds the telemetry from the
+/// requests on the mission control side.
+class TelemetryDeltaEncoder
+{
+ public:
+  static constexpr uint32_t kDefaultKeyframeInterval = 50;
+
+  /// @param deadband smallest speed and angle changes sent
+  /// @param keyframe_interval requests between keyframes
+  explicit TelemetryDeltaEncoder(
+      TelemetryDeadband deadband = {},
+      uint32_t keyframe_interval = kDefaultKeyframeInterval)
+      : deadband_(deadband), keyframe_interval_(keyframe_interval)
+  {
+  }
+
+  /// Appends the changed fields as query parameters
+  /// @param writer request being built, after the endpoint
+  /// @param telemetry latest snapshot from RoverDriveSystem::GetTelemetry()
+  /// @return TelemetryField flags of the fields written
+  uint16_t Write(common::RequestWriter & writer,
+                 const protocol::DriveTelemetry & telemetry)
+  {
+    bool is_keyframe = !has_acknowledged_ ||
+                       requests_since_keyframe_ >= keyframe_interval_;
+    uint16_t fields  = kAllTelemetry;
+    if (is_keyframe)
+    {
+      writer.AppendParameter(kKeyframeParameter, 1);
+    }
+    else
+    {
+      fields = GetChangedFields(telemetry);
+      requests_since_keyframe_++;
+    }
+
+    auto wheels = GetWheelFields(telemetry);
+    if (fields & kIsOperationalTelemetry)
+    {
+      writer.AppendParameter(kTelemetryParameters[0],
+                             telemetry.is_operational);
+    }
+    if (fields & kDriveModeTelemetry)
+    {
+      writer.AppendParameter(kTelemetryParameters[1], telemetry.drive_mode);
+    }
+    if (fields & kBatteryTelemetry)
+    {
+      writer.AppendParameter(kTelemetryParameters[2], telemetry.battery);
+    }
+    for (size_t i = 0; i < wheels.size(); i++)
+    {
+      if (fields & (kLeftSpeedTelemetry << i))
+      {
+        writer.AppendParameter(kTelemetryParameters[3 + i], *wheels[i]);
+      }
+    }
+
+    pending_             = telemetry;
+    pending_fields_      = fields;
+    pending_is_keyframe_ = is_keyframe;
+    return fields;
+  }
+
+  /// Marks the last request written as received by mission control. Its
+  /// fields become the reference later changes are measured against.
+  void Acknowledge()
+  {
+    if (pending_fields_ & kIsOperationalTelemetry)
+    {
+      acknowledged_.is_operational = pending_.is_operational;
+    }
+    if (pending_fields_ & kDriveModeTelemetry)
+    {
+      acknowledged_.drive_mode = pending_.drive_mode;
+    }
+    if (pending_fields_ & kBatteryTelemetry)
+    {
+      acknowledged_.battery = pending_.battery;
+    }
+    auto acknowledged_wheels = GetWheelFields(acknowledged_);
+    auto pending_wheels      = GetWheelFields(pending_);
+    for (size_t i = 0; i < pending_wheels.size(); i++)
+    {
+      if (pending_fields_ & (kLeftSpeedTelemetry << i))
+      {
+        *acknowledged_wheels[i] = *pending_wheels[i];
+      }
+    }
+
+    if (pending_is_keyframe_)
+    {
+      has_acknowledged_        = true;
+      requests_since_keyframe_ = 0;
+    }
+    pending_fields_      = 0;
+    pending_is_keyframe_ = false;
+  }
+
+  /// Sends a keyframe with the next request, i.e. after mission control
+  /// restarted
+  void RequestKeyframe()
+  {
+    has_acknowledged_ = false;
+  }
+
+ private:
+  uint16_t GetChangedFields(const protocol::DriveTelemetry & telemetry) const
+  {
+    uint16_t fields = 0;
+    if (telemetry.is_operational != acknowledged_.is_operational)
+    {
+      fields |= kIsOperationalTelemetry;
+    }
+    if (telemetry.drive_mode != acknowledged_.drive_mode)
+    {
+      fields |= kDriveModeTelemetry;
+    }
+    if (telemetry.battery != acknowledged_.battery)
+    {
+      fields |= kBatteryTelemetry;
+    }
+
+    auto wheels   = GetWheelFields(telemetry);
+    auto previous = GetWheelFields(acknowledged_);
+    for (size_t i = 0; i < wheels.size(); i++)
+    {
+      // Speeds and angles alternate
+      float deadband = (i % 2 == 0) ? deadband_.speed : deadband_.angle;
+      if (std::fabs(*wheels[i] - *previous[i]) > deadband)
+      {
+        fields |= kLeftSpeedTelemetry << i;
+      }
+    }
+    return fields;
+  }
+
+  TelemetryDeadband deadband_;
+  uint32_t keyframe_interval_;
+  protocol::DriveTelemetry acknowledged_;
+  protocol::DriveTelemetry pending_;
+  uint16_t pending_fields_          = 0;
+  bool pending_is_keyframe_         = false;
+  bool has_acknowledged_            = false;
+  uint32_t requests_since_keyframe_ = 0;
+};
+
+/// Mission control side of TelemetryDeltaEncoder: keeps the latest value of
+/// every telemetry field and updates it from each request's query string.
+/// Fields missing from a request keep their value.
+class TelemetryDeltaDecoder
+{
+ public:
+  /// Applies the parameters of one request. Unknown parameters are ignored.
+  /// @param query query string, with or without the path and '?' before it,
+  ///        i.e. drive?keyframe=1&is_operational=1&drive_mode=D...
+  /// @return TelemetryField flags of the fields updated
+  uint16_t Apply(std::string_view query)
+  {
+    size_t start = query.find('?');
+    if (start != std::string_view::npos)
+    {
+      query.remove_prefix(start + 1);
+    }
+
+    uint16_t fields = 0;
+    while (!query.empty())
+    {
+      size_t end                 = query.find('&');
+      std::string_view parameter = query.substr(0, end);
+      query.remove_prefix(end == std::string_view::npos ? query.size()
+                                                        : end + 1);
+      size_t equals = parameter.find('=');
+      if (equals == std::string_view::npos)
+      {
+        continue;
+      }
+      fields |= ApplyParameter(parameter.substr(0, equals),
+                               parameter.substr(equals + 1));
+    }
+    return fields;
+  }
+
+  /// @return true once a keyframe was applied, before that fields that have
+  ///         not been sent yet are at their defaults
+  bool HasKeyframe() const
+  {
+    return has_keyframe_;
+  }
+
+  const protocol::DriveTelemetry & GetTelemetry() const
+  {
+    return telemetry_;
+  }
+
+ private:
+  uint16_t ApplyParameter(std::string_view name, std::string_view text)
+  {
+    common::JsonValue value = { common::JsonValue::Type::kNumber, text };
+    int32_t integer;
+    if (name == kKeyframeParameter)
+    {
+      has_keyframe_ = true;
+      return 0;
+    }
+    if (name == kTelemetryParameters[0] && value.ToInteger(integer))
+    {
+      telemetry_.is_operational = integer;
+      return kIsOperationalTelemetry;
+    }
+    if (name == kTelemetryParameters[1] && text.size() == 1)
+    {
+      telemetry_.drive_mode = text.front();
+      return kDriveModeTelemetry;
+    }
+    if (name == kTelemetryParameters[2] && value.ToInteger(integer))
+    {
+      telemetry_.battery = integer;
+      return kBatteryTelemetry;
+    }
+
+    auto wheels = GetWheelFields(telemetry_);
+    for (size_t i = 0; i < wheels.size(); i++)
+    {
+      if (name == kTelemetryParameters[3 + i] && value.ToFloat(*wheels[i]))
+      {
+        return static_cast<uint16_t>(kLeftSpeedTelemetry << i);
+      }
+    }
+    return 0;
+  }
+
+  protocol::DriveTelemetry telemetry_;
+  bool has_keyframe_ = false;
+};
+}  // namespace sjsu::drive
@@ -0,0 +1,49 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/cycle_counter.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing CycleStatistics")
+{
+  common::CycleStatistics statistics;
+
+  SECTION("should be empty before recording")
+  {
+    CHECK(statistics.GetCount() == 0);
+    CHECK(statistics.GetMin() == 0);
+    CHECK(statistics.GetMean() == 0);
+  }
+
+  SECTION("should track min, mean and max")
+  {
+    statistics.Record(300);
+    statistics.Record(100);
+    statistics.Record(200);
+    CHECK(statistics.GetCount() == 3);
+    CHECK(statistics.GetMin() == 100);
+    CHECK(statistics.GetMean() == 200);
+    CHECK(statistics.GetMax() == 300);
+
+    statistics.Reset();
+    CHECK(statistics.GetCount() == 0);
+    CHECK(statistics.GetMax() == 0);
+  }
+
+  SECTION("should measure across a counter wrap")
+  {
+    uint32_t start = UINT32_MAX - 10;
+    uint32_t end   = 20;
+    statistics.Record(end - start);
+    CHECK(statistics.GetMax() == 31);
+  }
+
+  SECTION("should count forward")
+  {
+    common::CycleCounter::Enable();
+    uint32_t start = common::CycleCounter::Now();
+    uint32_t end   = common::CycleCounter::Now();
+    CHECK(end - start < 1'000'000'000);
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,140 @@
+#include "testing/testing_frameworks.hpp"
+
+#include <string>
+
+#include "../../Common/deferred_log.hpp"
+
+namespace sjsu
+{
+namespace
+{
+std::chrono::nanoseconds fake_uptime = 0ns;
+
+std::chrono::nanoseconds FakeUptime()
+{
+  return fake_uptime;
+}
+
+enum class Mode : char
+{
+  kDrive = 'D',
+};
+}  // namespace
+
+TEST_CASE("Testing DeferredLog")
+{
+  using Log = common::DeferredLog<4>;
+  Log log(FakeUptime);
+  Log::Entry entry;
+  std::array<char, 128> line;
+  fake_uptime = 1500us;
+
+  auto format_next = [&]() {
+    REQUIRE(log.Pop(entry));
+    Log::Format(entry, line);
+    return std::string(line.data());
+  };
+
+  SECTION("should record messages without formatting them")
+  {
+    const char * format = "speed: %f";
+    CHECK(log.Record(common::LogLevel::kInfo, format, 12.5f));
+
+    REQUIRE(log.Pop(entry));
+    CHECK(entry.format == format);
+    CHECK(entry.timestamp == 1500);
+    CHECK(entry.level == common::LogLevel::kInfo);
+    CHECK(entry.argument_count == 1);
+    CHECK(!log.Pop(entry));
+  }
+
+  SECTION("should format messages like printf")
+  {
+    log.Record(common::LogLevel::kInfo, "is_operational: %d", 1);
+    log.Record(common::LogLevel::kInfo, "drive_mode: %c", 'D');
+    log.Record(common::LogLevel::kInfo, "speed: %.2f, angle: %5.1f", 15.25f,
+               -30.0);
+    log.Record(common::LogLevel::kInfo, "%lu cycles, %lld ms, 100%%",
+               static_cast<unsigned long>(4000000000u),
+               static_cast<long long>(-1234567890123));
+
+    CHECK(format_next() == "is_operational: 1");
+    CHECK(format_next() == "drive_mode: D");
+    CHECK(format_next() == "speed: 15.25, angle: -30.0");
+    CHECK(format_next() == "4000000000 cycles, -1234567890123 ms, 100%");
+  }
+
+  SECTION("should format strings, enums and unsigned numbers")
+  {
+    log.Record(common::LogLevel::kWarning, "step %s missed", "actuation");
+    log.Record(common::LogLevel::kInfo, "mode %c fields 0x%02X", Mode::kDrive,
+               static_cast<uint8_t>(0x0B));
+    log.Record(common::LogLevel::kInfo, "%zu bytes", sizeof(uint64_t));
+
+    CHECK(format_next() == "step actuation missed");
+    CHECK(entry.level == common::LogLevel::kWarning);
+    CHECK(format_next() == "mode D fields 0x0B");
+    CHECK(format_next() == "8 bytes");
+  }
+
+  SECTION("should print missing arguments as written")
+  {
+    log.Record(common::LogLevel::kInfo, "left %d right %d", 5);
+    CHECK(format_next() == "left 5 right %d");
+  }
+
+  SECTION("should truncate long messages")
+  {
+    log.Record(common::LogLevel::kInfo, "speed: %d", 123456);
+    REQUIRE(log.Pop(entry));
+    std::array<char, 10> short_line;
+    CHECK(Log::Format(entry, short_line) == 9);
+    CHECK(std::string(short_line.data()) == "speed: 12");
+  }
+
+  SECTION("should drop messages once full and keep the oldest")
+  {
+    for (int i = 0; i < 6; i++)
+    {
+      CHECK(log.Record(common::LogLevel::kInfo, "message %d", i) == (i < 4));
+    }
+    CHECK(log.GetDroppedCount() == 2);
+
+    CHECK(format_next() == "message 0");
+    CHECK(log.Record(common::LogLevel::kInfo, "message %d", 6));
+    CHECK(format_next() == "message 1");
+    CHECK(format_next() == "message 2");
+    CHECK(format_next() == "message 3");
+    CHECK(format_next() == "message 6");
+    CHECK(!log.Pop(entry));
+  }
+
+  SECTION("should drain every message")
+  {
+    log.Record(common::LogLevel::kDebug, "a");
+    log.Record(common::LogLevel::kError, "b %d", 2);
+    log.Record(common::LogLevel::kInfo, "c");
+    CHECK(log.Drain(2) == 2);
+    CHECK(log.Drain() == 1);
+    CHECK(log.Drain() == 0);
+  }
+
+  SECTION("should leave out messages below the configured level")
+  {
+    decltype(common::deferred_log)::Entry unused;
+    while (common::deferred_log.Pop(unused))
+    {
+    }
+    common::DeferLogDebug("debug %d", 1);
+    common::DeferLogInfo("info %d", 2);
+    common::DeferLogError("error %d", 3);
+
+    // DEFERRED_LOG_LEVEL defaults to info
+    REQUIRE(common::deferred_log.Pop(unused));
+    CHECK(unused.level == common::LogLevel::kInfo);
+    REQUIRE(common::deferred_log.Pop(unused));
+    CHECK(unused.level == common::LogLevel::kError);
+    CHECK(!common::deferred_log.Pop(unused));
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,103 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "drive_protocol.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing Drive Binary Protocol")
+{
+  using namespace drive::protocol;
+
+  SECTION("should round trip command frames")
+  {
+    drive::MissionControlData sent = { 1, 'T', -45.5f, 87.25f };
+    std::array<uint8_t, kCommandFrameSize> frame;
+    CHECK(EncodeCommandFrame(sent, 0x1234, frame) == kCommandFrameSize);
+    CHECK(frame[0] == kFrameMagic);
+    CHECK(frame[1] == kProtocolVersion);
+    CHECK(frame[3] == 0x34);  // little endian sequence
+    CHECK(frame[4] == 0x12);
+
+    drive::MissionControlData received;
+    uint16_t sequence = 0;
+    CHECK(DecodeCommandFrame(frame, received, sequence) == FrameStatus::kOk);
+    CHECK(sequence == 0x1234);
+    CHECK(received.is_operational == 1);
+    CHECK(received.drive_mode == 'T');
+    CHECK(received.speed == doctest::Approx(87.25));
+    CHECK(received.rotation_angle == doctest::Approx(-45.5));
+  }
+
+  SECTION("should round trip telemetry frames")
+  {
+    DriveTelemetry sent;
+    sent.is_operational = 1;
+    sent.drive_mode     = 'D';
+    sent.battery        = 90;
+    sent.left           = { 10.5f, -45.0f };
+    sent.right          = { -100.0f, -135.0f };
+    sent.back           = { 0.01f, 359.9f };
+    std::array<uint8_t, kTelemetryFrameSize> frame;
+    CHECK(EncodeTelemetryFrame(sent, 7, frame) == kTelemetryFrameSize);
+
+    DriveTelemetry received;
+    uint16_t sequence = 0;
+    CHECK(DecodeTelemetryFrame(frame, received, sequence) == FrameStatus::kOk);
+    CHECK(sequence == 7);
+    CHECK(received.drive_mode == 'D');
+    CHECK(received.battery == 90);
+    CHECK(received.left.speed == doctest::Approx(10.5));
+    CHECK(received.right.speed == doctest::Approx(-100.0));
+    CHECK(received.right.angle == doctest::Approx(-135.0));
+    CHECK(received.back.speed == doctest::Approx(0.01));
+    CHECK(received.back.angle == doctest::Approx(359.9));
+  }
+
+  SECTION("should be several times smaller than the text protocol")
+  {
+    // Text telemetry is ~200 bytes of query string and commands ~70 bytes of
+    // JSON, before HTTP headers.
+    CHECK(kTelemetryFrameSize <= 200 / 5);
+    CHECK(kCommandFrameSize <= 70 / 5);
+  }
+
+  SECTION("should reject corrupt, short and mismatched frames")
+  {
+    drive::MissionControlData data;
+    uint16_t sequence;
+    std::array<uint8_t, kCommandFrameSize> frame;
+    EncodeCommandFrame(data, 1, frame);
+
+    CHECK(DecodeCommandFrame(std::span(frame).first(4), data, sequence) ==
+          FrameStatus::kTooShort);
+
+    frame[6] ^= 0x01;
+    CHECK(DecodeCommandFrame(frame, data, sequence) == FrameStatus::kBadCrc);
+    frame[6] ^= 0x01;
+
+    frame[1] = kProtocolVersion + 1;
+    CHECK(DecodeCommandFrame(frame, data, sequence) ==
+          FrameStatus::kBadVersion);
+
+    DriveTelemetry telemetry;
+    std::array<uint8_t, kTelemetryFrameSize> telemetry_frame;
+    EncodeTelemetryFrame(telemetry, 1, telemetry_frame);
+    CHECK(DecodeCommandFrame(telemetry_frame, data, sequence) ==
+          FrameStatus::kBadType);
+  }
+
+  SECTION("should saturate values that do not fit")
+  {
+    CHECK(ToFixed(1000.0f, kSpeedScale) == INT16_MAX);
+    CHECK(ToFixed(-1000.0f, kSpeedScale) == INT16_MIN);
+  }
+
+  SECTION("should order sequence numbers across wrap around")
+  {
+    CHECK(IsNewerSequence(2, 1));
+    CHECK(!IsNewerSequence(1, 1));
+    CHECK(!IsNewerSequence(1, 2));
+    CHECK(IsNewerSequence(0, 0xFFFF));
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,123 @@
+#include "testing/testing_frameworks.hpp"
+#include "peripherals/lpc40xx/can.hpp"
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/time/time.hpp"
+
+#include "drive_tasks.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing Drive Actuation Task")
+{
+  Mock<Can> mock_can;
+  Fake(Method(mock_can, Can::ModuleInitialize));
+  Fake(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &)));
+  Fake(Method(mock_can, Can::Receive));
+  Fake(Method(mock_can, Can::HasData));
+
+  Mock<Gpio> mock_homing_pin;
+  Fake(Method(mock_homing_pin, Gpio::ModuleInitialize));
+  Fake(Method(mock_homing_pin, Gpio::SetDirection));
+  When(Method(mock_homing_pin, Gpio::Read)).AlwaysReturn(Gpio::kLow);
+
+  StaticMemoryResource<1024> memory_resource;
+  CanNetwork network(mock_can.get(), &memory_resource);
+
+  sjsu::RmdX left_steer_motor(network, 0x141);
+  sjsu::RmdX left_hub_motor(network, 0x142);
+  sjsu::RmdX right_steer_motor(network, 0x143);
+  sjsu::RmdX right_hub_motor(network, 0x144);
+  sjsu::RmdX back_steer_motor(network, 0x145);
+  sjsu::RmdX back_hub_motor(network, 0x146);
+  drive::Wheel left_wheel(left_hub_motor, left_steer_motor,
+                          mock_homing_pin.get());
+  drive::Wheel right_wheel(right_hub_motor, right_steer_motor,
+                           mock_homing_pin.get());
+  drive::Wheel back_wheel(back_hub_motor, back_steer_motor,
+                          mock_homing_pin.get());
+  drive::RoverDriveSystem drive_system(left_wheel, right_wheel, back_wheel);
+  drive::DriveFeedbackCache feedback(network, { { { 0x141, 8 },
+                                                  { 0x142, 8 },
+                                                  { 0x143, 8 },
+                                                  { 0x144, 8 },
+                                                  { 0x145, 8 },
+                                                  { 0x146, 8 } } });
+
+  drive::CommandMailbox commands;
+  drive::TelemetryMailbox telemetry;
+  drive::ActuationTask actuation_task(drive_system, feedback, commands,
+                                      telemetry);
+  static drive::DriveFlightRecorder flight_recorder;
+  flight_recorder.Resume();
+  flight_recorder.TakeDumpRequest();
+  actuation_task.SetFlightRecorder(flight_recorder);
+
+  auto send = [&](char drive_mode) {
+    drive::TimestampedCommand command;
+    command.data.is_operational = 1;
+    command.data.drive_mode     = drive_mode;
+    command.received_at         = sjsu::Uptime();
+    commands.Write(command);
+  };
+
+  SECTION("should request a dump once per fault")
+  {
+    send('X');
+    actuation_task.Run();
+    CHECK(actuation_task.GetLastStatus() == common::Status::kInvalidMode);
+    CHECK(flight_recorder.TakeDumpRequest());
+
+    // The fault persists, the recorder is left to be dumped
+    flight_recorder.Resume();
+    for (int cycle = 0; cycle < 10; cycle++)
+    {
+      send('X');
+      actuation_task.Run();
+    }
+    CHECK(actuation_task.GetLastStatus() == common::Status::kInvalidMode);
+    CHECK(!flight_recorder.TakeDumpRequest());
+
+    // Recovered, then failed again
+    send('S');
+    actuation_task.Run();
+    CHECK(actuation_task.GetLastStatus() == common::Status::kOk);
+    CHECK(!flight_recorder.TakeDumpRequest());
+    send('X');
+    actuation_task.Run();
+    CHECK(flight_recorder.TakeDumpRequest());
+  }
+
+  SECTION("should hold the rover once homing fails")
+  {
+    // The slip ring mark is never found
+    When(Method(mock_homing_pin, Gpio::Read)).AlwaysReturn(Gpio::kHigh);
+    actuation_task.Setup();
+    CHECK(drive_system.GetHomingStatus() == drive::HomingStatus::kHoming);
+
+    int cycles = 0;
+    while (drive_system.GetHomingStatus() == drive::HomingStatus::kHoming &&
+           cycles < 1000)
+    {
+      send('D');
+      actuation_task.Run();
+      cycles++;
+    }
+    CHECK(drive_system.GetHomingStatus() == drive::HomingStatus::kFailed);
+    CHECK(actuation_task.GetLastStatus() == common::Status::kHomingFailed);
+    CHECK(flight_recorder.TakeDumpRequest());
+
+    drive::TimestampedCommand command;
+    command.data = { 1, 'D', 0.0f, 20.0f };
+    for (int cycle = 0; cycle < 100; cycle++)
+    {
+      command.received_at = sjsu::Uptime();
+      commands.Write(command);
+      actuation_task.Run();
+    }
+    CHECK(actuation_task.GetLastStatus() == common::Status::kHomingFailed);
+    CHECK(drive_system.GetCurrentMode() == 'S');
+    CHECK(left_wheel.GetSpeed() == doctest::Approx(0.0));
+    CHECK(back_wheel.GetSpeed() == doctest::Approx(0.0));
+  }
+}
+}  // namespace sjsu
@@ -1,22 +1,168 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include "testing/testing_frameworks.hpp"
 #include "utility/log.hpp"
 
 #include "../../Common/esp.hpp"
+#include "../../Common/host_socket.hpp"
 
 namespace sjsu
 {
+namespace
+{
+/// Accepts connections on a loopback port and answers every request on them
+/// with the same response, closing each connection after a number of
+/// responses
+class LoopbackServer
+{
+ public:
+  LoopbackServer(std::string response, int responses_per_connection)
+      : response_(std::move(response)),
+        responses_per_connection_(responses_per_connection)
+  {
+    listener_               = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address     = {};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listener_, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    listen(listener_, 4);
+    socklen_t length = sizeof(address);
+    getsockname(listener_, reinterpret_cast<sockaddr *>(&address), &length);
+    port_   = ntohs(address.sin_port);
+    thread_ = std::thread([this]() { Serve(); });
+  }
+
+  ~LoopbackServer()
+  {
+    // Wakes up the thread if it is waiting on a client that is still open
+    shutdown(connection_, SHUT_RDWR);
+    shutdown(listener_, SHUT_RDWR);
+    close(listener_);
+    thread_.join();
+  }
+
+  uint16_t GetPort() const
+  {
+    return port_;
+  }
+
+  std::string GetLastRequest()
+  {
+    std::lock_guard lock(mutex_);
+    return last_request_;
+  }
+
+ private:
+  void Serve()
+  {
+    int fd;
+    while ((fd = accept(listener_, nullptr, nullptr)) >= 0)
+    {
+      connection_ = fd;
+      std::string received;
+      char buffer[512];
+      int responses = 0;
+      ssize_t length;
+      while (responses < responses_per_connection_ &&
+             (length = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+      {
+        received.append(buffer, static_cast<size_t>(length));
+        size_t end;
+        while ((end = received.find("\r\n\r\n")) != std::string::npos)
+        {
+          {
+            std::lock_guard lock(mutex_);
+            last_request_ = received.substr(0, end);
+          }
+          received.erase(0, end + 4);
+          send(fd, response_.data(), response_.size(), MSG_NOSIGNAL);
+          responses++;
+        }
+      }
+      connection_ = -1;
+      close(fd);
+    }
+  }
+
+  std::string response_;
+  int responses_per_connection_;
+  int listener_;
+  std::atomic<int> connection_ = -1;
+  uint16_t port_;
+  std::mutex mutex_;
+  std::string last_request_;
+  std::thread thread_;
+};
+
+constexpr const char * kOkResponse =
+    "HTTP/1.1 200 OK\r\nContent-Length: 18\r\nConnection: keep-alive\r\n\r\n"
+    R"({"drive_mode":"D"})";
+}  // namespace
+
 TEST_CASE("Testing ESP Wi-Fi Module")
 {
-  // Mock<common::Esp> esp;
-  // Fake(Method(esp, common::Esp::Initialize));
-  SECTION("should initialize esp wi-fi module")
+  common::HostWiFi wifi;
+  common::HostSocket socket;
+  std::array<char, 256> response_body;
+
+  SECTION("should connect to wifi on the first link update, not on boot")
   {
+    common::Esp esp(wifi, socket, "127.0.0.1", 80);
     esp.Initialize();
+    CHECK(!wifi.IsConnected());
+    CHECK(esp.MaintainLink());
+    CHECK(wifi.IsConnected());
+    CHECK(esp.GetLink().GetStatistics().attempts == 1);
   }
 
-  SECTION("should make get request to jsonplaceholder.typicode.com/todos/1")
+  SECTION("should return the response body and keep the connection open")
   {
-    esp.GETRequest("?example=3");
+    LoopbackServer server(kOkResponse, 100);
+    common::Esp esp(wifi, socket, "127.0.0.1", server.GetPort());
+
+    CHECK(esp.GETRequest("drive?speed=1", response_body) ==
+          R"({"drive_mode":"D"})");
+    CHECK(server.GetLastRequest().starts_with("GET /drive?speed=1 HTTP/1.1"));
+    CHECK(esp.GETRequest("drive?speed=2", response_body) ==
+          R"({"drive_mode":"D"})");
+    CHECK(esp.GetConnectionCount() == 1);
+  }
+
+  SECTION("should reconnect if the server closed the connection")
+  {
+    LoopbackServer server(kOkResponse, 1);
+    common::Esp esp(wifi, socket, "127.0.0.1", server.GetPort());
+
+    CHECK(esp.GETRequest("drive", response_body) == R"({"drive_mode":"D"})");
+    CHECK(esp.GETRequest("drive", response_body) == R"({"drive_mode":"D"})");
+    CHECK(esp.GetConnectionCount() == 2);
+  }
+
+  SECTION("should return an empty body on an error status")
+  {
+    LoopbackServer server(
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n", 100);
+    common::Esp esp(wifi, socket, "127.0.0.1", server.GetPort());
+
+    CHECK(esp.GETRequest("nope", response_body).empty());
+  }
+
+  SECTION("should end a body without a length once the read times out")
+  {
+    LoopbackServer server("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n"
+                          R"({"drive_mode":"S"})",
+                          1);
+    common::Esp esp(wifi, socket, "127.0.0.1", server.GetPort());
+
+    CHECK(esp.GETRequest("drive", response_body) == R"({"drive_mode":"S"})");
+    CHECK(!esp.IsConnectedToServer());
   }
 }
-}  // namespace sjsu
\ No newline at end of file
+}  // namespace sjsu
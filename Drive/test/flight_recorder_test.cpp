@@ -0,0 +1,138 @@
+#include "testing/testing_frameworks.hpp"
+
+#include <string>
+#include <vector>
+
+#include "../../Common/flight_recorder.hpp"
+#include "flight_record.hpp"
+
+namespace sjsu
+{
+namespace
+{
+struct TestRecord
+{
+  uint32_t tick = 0;
+  int16_t value = 0;
+  uint8_t flags = 0;
+  char mode     = 'S';
+};
+}  // namespace
+
+TEST_CASE("Testing FlightRecorder")
+{
+  common::FlightRecorder<TestRecord, 4> recorder;
+  auto capture = [&](uint32_t tick) {
+    recorder.Capture({ tick, static_cast<int16_t>(-tick), 0x80, 'D' });
+  };
+
+  SECTION("should hold the records in capture order")
+  {
+    capture(1);
+    capture(2);
+    REQUIRE(recorder.GetCount() == 2);
+    CHECK(recorder.Get(0).tick == 1);
+    CHECK(recorder.Get(1).tick == 2);
+  }
+
+  SECTION("should overwrite the oldest records once full")
+  {
+    for (uint32_t tick = 1; tick <= 6; tick++)
+    {
+      capture(tick);
+    }
+    REQUIRE(recorder.GetCount() == 4);
+    CHECK(recorder.GetCapturedCount() == 6);
+    CHECK(recorder.Get(0).tick == 3);
+    CHECK(recorder.Get(3).tick == 6);
+  }
+
+  SECTION("should keep the records while frozen")
+  {
+    capture(1);
+    recorder.Freeze();
+    capture(2);
+    CHECK(recorder.IsFrozen());
+    CHECK(recorder.GetCount() == 1);
+
+    recorder.Resume();
+    capture(3);
+    CHECK(recorder.Get(1).tick == 3);
+  }
+
+  SECTION("should freeze and request a dump once")
+  {
+    CHECK(!recorder.TakeDumpRequest());
+    recorder.RequestDump();
+    CHECK(recorder.IsFrozen());
+    CHECK(recorder.TakeDumpRequest());
+    CHECK(!recorder.TakeDumpRequest());
+  }
+
+  SECTION("should dump records that parse back to the same values")
+  {
+    for (uint32_t tick = 1; tick <= 5; tick++)
+    {
+      capture(tick);
+    }
+    std::vector<std::string> lines;
+    recorder.Dump([&](const char * line) { lines.push_back(line); });
+
+    REQUIRE(lines.size() == 6);
+    CHECK(lines[0] == "FLIGHT RECORDER BEGIN 8 4");
+    // Little endian tick 2, value -2, flags 0x80, mode 'D'
+    CHECK(lines[1] == "02000000FEFF8044");
+    CHECK(lines[5] == "FLIGHT RECORDER END");
+
+    TestRecord record;
+    REQUIRE(decltype(recorder)::ParseDumpLine(lines[4] + "\r\n", record));
+    CHECK(record.tick == 5);
+    CHECK(record.value == -5);
+    CHECK(record.flags == 0x80);
+    CHECK(record.mode == 'D');
+  }
+
+  SECTION("should reject lines that are not records")
+  {
+    TestRecord record;
+    CHECK(!decltype(recorder)::ParseDumpLine("FLIGHT RECORDER END", record));
+    CHECK(!decltype(recorder)::ParseDumpLine("02000000FEFF80", record));
+    CHECK(!decltype(recorder)::ParseDumpLine("02000000FEFF80XY", record));
+  }
+}
+
+TEST_CASE("Testing FlightRecord")
+{
+  drive::FlightRecord record;
+  record.timestamp        = 1'250'000;
+  record.actuation_cycles = 4200;
+  record.command_speed    = 1525;  // 0.01 rpm
+  record.command_angle    = -300;  // 0.1 degrees
+  record.is_operational   = 1;
+  record.command_mode     = 'D';
+  record.current_mode     = 'S';
+  record.flags            = drive::FlightRecord::kSwitching;
+
+  record.back.measured_angle = 895;
+
+  SECTION("should write a CSV row in physical units")
+  {
+    FILE * file = tmpfile();
+    REQUIRE(file != nullptr);
+    drive::WriteFlightRecordCsvHeader(file);
+    drive::WriteFlightRecordCsv(file, record);
+    rewind(file);
+
+    char header[512];
+    char row[512];
+    REQUIRE(fgets(header, sizeof(header), file) != nullptr);
+    REQUIRE(fgets(row, sizeof(row), file) != nullptr);
+    fclose(file);
+
+    CHECK(std::string(header).starts_with("time_s,actuation_cycles,"));
+    CHECK(std::string(row) ==
+          "1.250000,4200,1,D,15.25,-30.0,S,0,0,1,"
+          "0.00,0.0,0.00,0.0,0.00,0.0,0.00,0.0,0.00,0.0,0.00,89.5\n");
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,115 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/http_response_parser.hpp"
+
+namespace sjsu
+{
+namespace
+{
+std::span<const uint8_t> AsBytes(std::string_view text)
+{
+  return std::span<const uint8_t>(
+      reinterpret_cast<const uint8_t *>(text.data()), text.size());
+}
+}  // namespace
+
+TEST_CASE("Testing HTTP Response Parser")
+{
+  std::array<char, 64> body;
+  common::HttpResponseParser parser(body);
+
+  SECTION("should parse a Content-Length response")
+  {
+    std::string_view response =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json\r\n"
+        "content-length: 17\r\n"
+        "\r\n"
+        R"({"speed": 10.00})"
+        "\n";
+    CHECK(parser.Parse(AsBytes(response)) == response.size());
+    CHECK(parser.IsComplete());
+    CHECK(parser.GetStatusCode() == 200);
+    CHECK(parser.IsKeepAlive());
+    CHECK(parser.GetBody() == "{\"speed\": 10.00}\n");
+  }
+
+  SECTION("should resume parsing across reads split at any byte")
+  {
+    std::string_view response =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 2\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "{}";
+    for (size_t i = 0; i < response.size(); i++)
+    {
+      CHECK(!parser.IsDone());
+      parser.Parse(AsBytes(response.substr(i, 1)));
+    }
+    CHECK(parser.IsComplete());
+    CHECK(!parser.IsKeepAlive());
+    CHECK(parser.GetBody() == "{}");
+  }
+
+  SECTION("should finish as soon as the body is complete")
+  {
+    std::string_view response =
+        "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n{}HTTP/1.1 200 OK";
+    CHECK(parser.Parse(AsBytes(response)) == response.size() - 15);
+    CHECK(parser.IsComplete());
+  }
+
+  SECTION("should parse a chunked response")
+  {
+    std::string_view response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\n{\"a\":\r\n"
+        "3;ext=1\r\n 1}\r\n"
+        "0\r\n"
+        "\r\n";
+    parser.Parse(AsBytes(response.substr(0, 40)));
+    CHECK(!parser.IsDone());
+    parser.Parse(AsBytes(response.substr(40)));
+    CHECK(parser.IsComplete());
+    CHECK(parser.GetBody() == "{\"a\": 1}");
+  }
+
+  SECTION("should read until close when there is no length")
+  {
+    parser.Parse(AsBytes("HTTP/1.0 200 OK\r\n\r\n{\"a\": 1}"));
+    CHECK(!parser.IsDone());
+    parser.ConnectionClosed();
+    CHECK(parser.IsComplete());
+    CHECK(!parser.IsKeepAlive());
+    CHECK(parser.GetBody() == "{\"a\": 1}");
+  }
+
+  SECTION("should skip 100 Continue and report error statuses")
+  {
+    parser.Parse(AsBytes(
+        "HTTP/1.1 100 Continue\r\n\r\n"
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n"));
+    CHECK(parser.IsComplete());
+    CHECK(parser.GetStatusCode() == 404);
+  }
+
+  SECTION("should truncate bodies larger than the buffer")
+  {
+    std::array<char, 4> small_body;
+    parser.Reset(small_body);
+    parser.Parse(AsBytes("HTTP/1.1 200 OK\r\nContent-Length: 6\r\n\r\n123456"));
+    CHECK(parser.IsComplete());
+    CHECK(parser.IsTruncated());
+    CHECK(parser.GetBody() == "1234");
+  }
+
+  SECTION("should flag malformed responses")
+  {
+    parser.Parse(AsBytes("garbage\r\n"));
+    CHECK(parser.HasError());
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,72 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/json_reader.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing JSON Reader")
+{
+  SECTION("should walk every key/value pair in order")
+  {
+    common::JsonReader reader(
+        R"({"a": "text", "b": -1.5e2, "c": false, "d": null, "e": {"f": "}"}})");
+
+    CHECK(reader.Next());
+    CHECK(reader.GetKey() == "a");
+    CHECK(reader.GetValue().type == common::JsonValue::Type::kString);
+    CHECK(reader.GetValue().text == "text");
+
+    CHECK(reader.Next());
+    CHECK(reader.GetKey() == "b");
+    float number = 0;
+    CHECK(reader.GetValue().ToFloat(number));
+    CHECK(number == doctest::Approx(-150.0));
+
+    CHECK(reader.Next());
+    bool boolean = true;
+    CHECK(reader.GetValue().ToBoolean(boolean));
+    CHECK(!boolean);
+
+    CHECK(reader.Next());
+    CHECK(reader.GetValue().type == common::JsonValue::Type::kNull);
+
+    CHECK(reader.Next());
+    CHECK(reader.GetKey() == "e");
+    CHECK(reader.GetValue().type == common::JsonValue::Type::kObject);
+    CHECK(reader.GetValue().text == R"({"f": "}"})");
+
+    CHECK(!reader.Next());
+    CHECK(!reader.HasError());
+  }
+
+  SECTION("should convert numbers")
+  {
+    float number = 0;
+    int32_t integer = 0;
+    CHECK(common::JsonValue{ common::JsonValue::Type::kNumber, "0.125" }
+              .ToFloat(number));
+    CHECK(number == doctest::Approx(0.125));
+    CHECK(common::JsonValue{ common::JsonValue::Type::kNumber, "-42" }
+              .ToInteger(integer));
+    CHECK(integer == -42);
+    CHECK(!common::JsonValue{ common::JsonValue::Type::kNumber, "1.5" }
+               .ToInteger(integer));
+    CHECK(!common::JsonValue{ common::JsonValue::Type::kNumber, "1.2.3" }
+               .ToFloat(number));
+    CHECK(!common::JsonValue{ common::JsonValue::Type::kNumber, "-" }
+               .ToFloat(number));
+  }
+
+  SECTION("should report malformed or truncated objects")
+  {
+    common::JsonReader missing_colon(R"({"a" 1})");
+    CHECK(!missing_colon.Next());
+    CHECK(missing_colon.HasError());
+
+    common::JsonReader truncated(R"({"a": 1, "b": )");
+    CHECK(truncated.Next());
+    CHECK(!truncated.Next());
+    CHECK(truncated.HasError());
+  }
+}
+}  // namespace sjsu
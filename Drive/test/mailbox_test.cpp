@@ -0,0 +1,58 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/mailbox.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing Mailbox")
+{
+  common::Mailbox<int> mailbox;
+  int value = -1;
+
+  SECTION("should read the default value before anything is written")
+  {
+    CHECK(!mailbox.HasNewValue());
+    CHECK(!mailbox.Read(value));
+    CHECK(value == 0);
+    CHECK(mailbox.GetWriteCount() == 0);
+  }
+
+  SECTION("should only keep the latest value")
+  {
+    mailbox.Write(1);
+    mailbox.Write(2);
+    mailbox.Write(3);
+    CHECK(mailbox.HasNewValue());
+    CHECK(mailbox.Read(value));
+    CHECK(value == 3);
+    CHECK(mailbox.GetWriteCount() == 3);
+  }
+
+  SECTION("should keep returning the last value until a new one arrives")
+  {
+    mailbox.Write(7);
+    CHECK(mailbox.Read(value));
+    CHECK(!mailbox.Read(value));
+    CHECK(value == 7);
+
+    mailbox.Write(8);
+    CHECK(mailbox.Read(value));
+    CHECK(value == 8);
+  }
+
+  SECTION("should never hand out a buffer the producer is writing")
+  {
+    for (int i = 0; i <= 10; i++)
+    {
+      mailbox.Write(i);
+      if (i % 3 == 0)
+      {
+        CHECK(mailbox.Read(value));
+        CHECK(value == i);
+      }
+    }
+    CHECK(mailbox.Read(value));
+    CHECK(value == 10);
+  }
+}
+}  // namespace sjsu
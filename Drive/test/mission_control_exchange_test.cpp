@@ -0,0 +1,169 @@
+#include <string_view>
+
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Arm/arm_client.hpp"
+#include "../../Common/host_socket.hpp"
+#include "../../Common/mission_control_exchange.hpp"
+#include "../drive_client.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing Mission Control Exchange")
+{
+  common::HostWiFi wifi;
+  common::HostSocket socket;
+  common::Esp esp(wifi, socket, "127.0.0.1", 80);
+  common::MissionControlExchange exchange(esp);
+
+  drive::CommandMailbox drive_commands;
+  drive::TelemetryMailbox drive_telemetry;
+  drive::DriveClient drive_client(drive_commands, drive_telemetry);
+  arm::ArmCommandMailbox arm_commands;
+  arm::ArmTelemetryMailbox arm_telemetry;
+  arm::ArmClient arm_client(arm_commands, arm_telemetry);
+
+  REQUIRE(exchange.AddClient(drive_client));
+  REQUIRE(exchange.AddClient(arm_client));
+
+  drive::protocol::DriveTelemetry driving;
+  driving.is_operational = 1;
+  driving.drive_mode     = 'D';
+  driving.battery        = 87;
+  driving.left           = { 20.0f, -45.0f };
+  driving.right          = { 20.0f, -135.0f };
+  driving.back           = { 20.0f, 90.0f };
+  drive_telemetry.Write(driving);
+
+  arm::MissionControlData holding;
+  holding.is_operational = 1;
+  holding.rotunda        = 30.0f;
+  holding.wrist_pitch    = -15.0f;
+  arm_telemetry.Write(holding);
+
+  common::StaticRequestWriter<common::Esp::kRequestCapacity> request;
+
+  SECTION("should put the telemetry of every client in one request")
+  {
+    exchange.WriteRequest(request);
+    CHECK(request.GetView() ==
+          "Vishnu-Adda/json-robo-test/rover"
+          "?subsystem=drive&keyframe=1&is_operational=1&drive_mode=D"
+          "&battery=87&left_wheel_speed=20.00&left_wheel_angle=-45.00"
+          "&right_wheel_speed=20.00&right_wheel_angle=-135.00"
+          "&back_wheel_speed=20.00&back_wheel_angle=90.00"
+          "&subsystem=arm&is_operational=1&rotunda=30.00&shoulder=0.00"
+          "&elbow=0.00&wrist_pitch=-15.00&wrist_roll=0.00");
+  }
+
+  SECTION("should fit the largest telemetry of both clients in a request")
+  {
+    driving.left  = { -1000.0f, -180.0f };
+    driving.right = { -1000.0f, -180.0f };
+    driving.back  = { -1000.0f, -180.0f };
+    drive_telemetry.Write(driving);
+    holding = { 1, -360.0f, -360.0f, -360.0f, -360.0f, -360.0f };
+    arm_telemetry.Write(holding);
+
+    request.Append("GET /");
+    exchange.WriteRequest(request);
+    request.Append(" HTTP/1.1\r\nHost: ")
+        .Append(common::Esp::kDefaultUrl)
+        .Append("\r\nConnection: keep-alive\r\n\r\n");
+    CHECK(!request.HasOverflowed());
+  }
+
+  SECTION("should hand each client its part of one response")
+  {
+    exchange.WriteRequest(request);
+    CHECK(exchange.DispatchResponse(
+              R"({"drive": {"is_operational": 1, "drive_mode": "D",)"
+              R"( "speed": 20, "angle": 15},)"
+              R"( "arm": {"is_operational": 1, "rotunda": 30,)"
+              R"( "shoulder": 45, "elbow": 60, "wrist_pitch": -15,)"
+              R"( "wrist_roll": 0}})") == common::Status::kOk);
+
+    drive::TimestampedCommand drive_command;
+    CHECK(drive_commands.Read(drive_command));
+    CHECK(drive_command.data.drive_mode == 'D');
+    CHECK(drive_command.data.speed == doctest::Approx(20.0));
+    CHECK(drive_command.data.rotation_angle == doctest::Approx(15.0));
+
+    arm::MissionControlData arm_command;
+    CHECK(arm_commands.Read(arm_command));
+    CHECK(arm_command.is_operational == 1);
+    CHECK(arm_command.shoulder == doctest::Approx(45.0));
+    CHECK(arm_command.wrist_pitch == doctest::Approx(-15.0));
+
+    // The drive telemetry was acknowledged, only changes are sent next
+    request.Clear();
+    exchange.WriteRequest(request);
+    CHECK(request.GetView().starts_with(
+        "Vishnu-Adda/json-robo-test/rover?subsystem=drive&subsystem=arm&"));
+  }
+
+  SECTION("should report a client missing from the response")
+  {
+    CHECK(exchange.DispatchResponse(
+              R"({"drive": {"drive_mode": "S"}, "mast": {"pan": 10}})") ==
+          common::Status::kBadResponse);
+
+    drive::TimestampedCommand drive_command;
+    CHECK(drive_commands.Read(drive_command));
+    CHECK(drive_command.data.drive_mode == 'S');
+    CHECK(!arm_commands.HasNewValue());
+  }
+
+  SECTION("should only accept as many clients as it has room for")
+  {
+    for (size_t i = exchange.GetClientCount();
+         i < common::MissionControlExchange::kMaxClients; i++)
+    {
+      CHECK(exchange.AddClient(arm_client));
+    }
+    CHECK(!exchange.AddClient(arm_client));
+  }
+}
+
+TEST_CASE("Testing Mission Control Exchange with a single client")
+{
+  common::HostWiFi wifi;
+  common::HostSocket socket;
+  common::Esp esp(wifi, socket, "127.0.0.1", 80);
+  common::MissionControlExchange exchange(esp);
+
+  drive::CommandMailbox drive_commands;
+  drive::TelemetryMailbox drive_telemetry;
+  drive::DriveClient drive_client(drive_commands, drive_telemetry);
+  REQUIRE(exchange.AddClient(drive_client));
+
+  drive::protocol::DriveTelemetry driving;
+  driving.is_operational = 1;
+  driving.drive_mode     = 'S';
+  drive_telemetry.Write(driving);
+
+  common::StaticRequestWriter<common::Esp::kRequestCapacity> request;
+
+  SECTION("should use the client's own endpoint")
+  {
+    exchange.WriteRequest(request);
+    CHECK(request.GetView().starts_with(
+        "Vishnu-Adda/json-robo-test/drive?keyframe=1&is_operational=1&"
+        "drive_mode=S&"));
+    CHECK(request.GetView().find("subsystem") == std::string_view::npos);
+  }
+
+  SECTION("should hand the client the whole response")
+  {
+    CHECK(exchange.DispatchResponse(
+              R"({"is_operational": 1, "drive_mode": "T",)"
+              R"( "speed": 10, "angle": -20})") == common::Status::kOk);
+
+    drive::TimestampedCommand drive_command;
+    CHECK(drive_commands.Read(drive_command));
+    CHECK(drive_command.data.drive_mode == 'T');
+    CHECK(drive_command.data.speed == doctest::Approx(10.0));
+    CHECK(drive_command.data.rotation_angle == doctest::Approx(-20.0));
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,122 @@
+#include "testing/testing_frameworks.hpp"
+#include "peripherals/lpc40xx/can.hpp"
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/math/units.hpp"
+
+#include "motor_feedback.hpp"
+#include "wheel.hpp"
+
+namespace sjsu
+{
+namespace
+{
+Can::Message_t Reply(uint32_t id, std::array<uint8_t, 8> payload)
+{
+  Can::Message_t message;
+  message.id      = id;
+  message.length  = 8;
+  message.payload = payload;
+  return message;
+}
+}  // namespace
+
+TEST_CASE("Testing MotorFeedbackCache")
+{
+  Mock<Can> mock_can;
+  Fake(Method(mock_can, Can::ModuleInitialize));
+  Fake(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &)));
+  Fake(Method(mock_can, Can::Receive));
+  Fake(Method(mock_can, Can::HasData));
+
+  StaticMemoryResource<1024> memory_resource;
+  CanNetwork network(mock_can.get(), &memory_resource);
+
+  drive::MotorFeedbackCache<2> cache(network,
+                                     { { { 0x141, 8 }, { 0x142, 1 } } });
+
+  SECTION("should start without feedback")
+  {
+    CHECK(!cache.GetFeedback(0x141)->HasStatus());
+    CHECK(!cache.GetFeedback(0x141)->HasAngle());
+    CHECK(cache.GetFeedback(0x150) == nullptr);
+  }
+
+  SECTION("should decode status replies at the output shaft")
+  {
+    // 40C, 1024 current units, 480dps, encoder ignored
+    CHECK(cache.Decode(Reply(0x141, { 0x9C, 40, 0, 0x04, 0xE0, 0x01, 0, 0 })));
+    const drive::MotorFeedback * feedback = cache.GetFeedback(0x141);
+    CHECK(feedback->HasStatus());
+    CHECK(feedback->temperature.to<double>() == doctest::Approx(40));
+    CHECK(feedback->current.to<double>() == doctest::Approx(16.5));
+    // 480dps / 6 / 8 gear ratio
+    CHECK(feedback->speed.to<double>() == doctest::Approx(10));
+  }
+
+  SECTION("should decode replies to speed commands")
+  {
+    // -60dps = 0xFFC4
+    CHECK(cache.Decode(Reply(0x142, { 0xA2, 25, 0, 0, 0xC4, 0xFF, 0, 0 })));
+    CHECK(cache.GetFeedback(0x142)->speed.to<double>() == doctest::Approx(-10));
+  }
+
+  SECTION("should decode signed multi-turn angles")
+  {
+    // 72000 = 720deg at the motor, 90deg after the 8:1 gear ratio
+    CHECK(cache.Decode(Reply(0x141, { 0x92, 0x40, 0x19, 0x01, 0, 0, 0, 0 })));
+    CHECK(cache.GetFeedback(0x141)->HasAngle());
+    CHECK(cache.GetFeedback(0x141)->angle.to<double>() == doctest::Approx(90));
+
+    // -4500 = -45deg
+    CHECK(cache.Decode(
+        Reply(0x142, { 0x92, 0x6C, 0xEE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF })));
+    CHECK(cache.GetFeedback(0x142)->angle.to<double>() == doctest::Approx(-45));
+  }
+
+  SECTION("should ignore unknown motors and commands")
+  {
+    CHECK(!cache.Decode(Reply(0x150, { 0x9C, 40, 0, 0, 0, 0, 0, 0 })));
+    CHECK(!cache.Decode(Reply(0x141, { 0x30, 40, 0, 0, 0, 0, 0, 0 })));
+    CHECK(!cache.GetFeedback(0x141)->HasStatus());
+  }
+
+  SECTION("should send one staggered request per update")
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      cache.Update();
+    }
+    CHECK(cache.GetRequestCount() == 4);
+    Verify(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &))
+               .Matching([](const Can::Message_t & message) {
+                 return message.id == 0x141 && message.payload[0] == 0x9C;
+               }))
+        .Once();
+    Verify(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &))
+               .Matching([](const Can::Message_t & message) {
+                 return message.id == 0x142 && message.payload[0] == 0x92;
+               }))
+        .Once();
+  }
+
+  SECTION("should report measured wheel state relative to home")
+  {
+    sjsu::RmdX hub_motor(network, 0x142);
+    sjsu::RmdX steer_motor(network, 0x141);
+    drive::Wheel wheel(hub_motor, steer_motor);
+
+    // Commanded values until feedback arrives
+    wheel.SetFeedback(cache.GetFeedback(0x142), cache.GetFeedback(0x141));
+    CHECK(wheel.GetMeasuredSpeed() == doctest::Approx(0));
+    CHECK(wheel.GetMeasuredPosition() == doctest::Approx(0));
+
+    // Home at 90deg, then the steer motor moves to 135deg
+    cache.Decode(Reply(0x141, { 0x92, 0x40, 0x19, 0x01, 0, 0, 0, 0 }));
+    wheel.HomeWheel();
+    cache.Decode(Reply(0x141, { 0x92, 0xE0, 0xA5, 0x01, 0, 0, 0, 0 }));
+    cache.Decode(Reply(0x142, { 0x9C, 25, 0, 0, 0x3C, 0x00, 0, 0 }));
+    CHECK(wheel.GetMeasuredPosition() == doctest::Approx(45));
+    CHECK(wheel.GetMeasuredSpeed() == doctest::Approx(10));
+  }
+}
+}  // namespace sjsu
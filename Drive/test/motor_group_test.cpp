@@ -0,0 +1,106 @@
+#include "testing/testing_frameworks.hpp"
+#include "peripherals/lpc40xx/can.hpp"
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/math/units.hpp"
+
+#include "motor_group.hpp"
+#include "rover_drive_system.hpp"
+#include "wheel.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing MotorGroup")
+{
+  Mock<Can> mock_can;
+  Fake(Method(mock_can, Can::ModuleInitialize));
+  Fake(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &)));
+  Fake(Method(mock_can, Can::Receive));
+  Fake(Method(mock_can, Can::HasData));
+
+  StaticMemoryResource<1024> memory_resource;
+  CanNetwork network(mock_can.get(), &memory_resource);
+
+  sjsu::RmdX left_hub_motor(network, 0x142);
+  sjsu::RmdX right_hub_motor(network, 0x144);
+  sjsu::RmdX back_hub_motor(network, 0x146);
+
+  left_hub_motor.settings.gear_ratio  = 8;
+  right_hub_motor.settings.gear_ratio = 8;
+  back_hub_motor.settings.gear_ratio  = 8;
+
+  drive::MotorGroup<3> hub_motors(
+      network, { &left_hub_motor, &right_hub_motor, &back_hub_motor });
+
+  SECTION("should encode speed commands like RmdX")
+  {
+    // 10rpm * 6 dps/rpm * 8 gear ratio * 100 = 48000 = 0xBB80
+    std::array<uint8_t, 8> expected = { 0xA2, 0, 0, 0, 0x80, 0xBB, 0, 0 };
+    CHECK(drive::MotorGroup<3>::EncodeSpeed(10_rpm, 8) == expected);
+
+    // -1rpm * 6 * 1 * 100 = -600 = 0xFFFFFDA8
+    expected = { 0xA2, 0, 0, 0, 0xA8, 0xFD, 0xFF, 0xFF };
+    CHECK(drive::MotorGroup<3>::EncodeSpeed(-1_rpm, 1) == expected);
+  }
+
+  SECTION("should encode position commands like RmdX")
+  {
+    // 90deg * 8 * 100 = 72000 = 0x11940, 20rpm * 6 * 8 = 960 = 0x3C0
+    std::array<uint8_t, 8> expected = { 0xA4, 0,    0xC0, 0x03,
+                                        0x40, 0x19, 0x01, 0x00 };
+    CHECK(drive::MotorGroup<3>::EncodePosition(90_deg, 20_rpm, 8) ==
+          expected);
+  }
+
+  SECTION("should send individual frames unless broadcast is enabled")
+  {
+    hub_motors.SetSpeed(10_rpm);
+    CHECK(hub_motors.GetBroadcastFrames() == 0);
+    CHECK(hub_motors.GetIndividualFrames() == 3);
+  }
+
+  SECTION("should broadcast identical commands in one frame")
+  {
+    hub_motors.settings.use_broadcast = true;
+    hub_motors.SetSpeed(10_rpm);
+    hub_motors.SetAngle({ 45_deg, 45_deg, 45_deg }, 20_rpm);
+    CHECK(hub_motors.GetBroadcastFrames() == 2);
+    CHECK(hub_motors.GetIndividualFrames() == 0);
+    Verify(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &))
+               .Matching([](const Can::Message_t & message) {
+                 return message.id == 0x280 && message.payload[0] == 0xA2;
+               }))
+        .Once();
+  }
+
+  SECTION("should fall back to individual frames for different commands")
+  {
+    hub_motors.settings.use_broadcast = true;
+    hub_motors.SetSpeed({ 10_rpm, 10_rpm, -10_rpm });
+    CHECK(hub_motors.GetBroadcastFrames() == 0);
+    CHECK(hub_motors.GetIndividualFrames() == 3);
+
+    back_hub_motor.settings.gear_ratio = 6;
+    hub_motors.SetSpeed(10_rpm);
+    CHECK(hub_motors.GetBroadcastFrames() == 0);
+    CHECK(hub_motors.GetIndividualFrames() == 6);
+  }
+
+  SECTION("should set drive system wheel speeds through the group")
+  {
+    sjsu::RmdX left_steer_motor(network, 0x141);
+    sjsu::RmdX right_steer_motor(network, 0x143);
+    sjsu::RmdX back_steer_motor(network, 0x145);
+    drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+    drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
+    drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+    drive::RoverDriveSystem drive_system(left_wheel, right_wheel, back_wheel);
+    drive_system.SetHubMotorGroup(hub_motors);
+
+    drive_system.SetWheelSpeed(150_rpm);
+    CHECK(hub_motors.GetIndividualFrames() == 3);
+    CHECK(left_wheel.GetSpeed() == doctest::Approx(100.0));
+    CHECK(right_wheel.GetSpeed() == doctest::Approx(100.0));
+    CHECK(back_wheel.GetSpeed() == doctest::Approx(100.0));
+  }
+}
+}  // namespace sjsu
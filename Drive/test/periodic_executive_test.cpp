@@ -0,0 +1,164 @@
+#include "testing/testing_frameworks.hpp"
+
+#include <array>
+#include <string_view>
+
+#include "../../Common/periodic_executive.hpp"
+
+namespace sjsu
+{
+namespace
+{
+std::chrono::nanoseconds fake_time = 0ns;
+std::chrono::nanoseconds FakeUptime()
+{
+  return fake_time;
+}
+void FakeDelay(std::chrono::nanoseconds delay)
+{
+  fake_time += delay;
+}
+}  // namespace
+
+TEST_CASE("Testing TimingStatistics")
+{
+  common::TimingStatistics statistics;
+
+  SECTION("should be empty before recording")
+  {
+    CHECK(statistics.GetCount() == 0);
+    CHECK(statistics.GetMean() == 0us);
+    CHECK(statistics.GetPercentile(99) == 0us);
+  }
+
+  SECTION("should track min, max and mean")
+  {
+    statistics.Record(100us);
+    statistics.Record(300us);
+    statistics.Record(200us);
+    CHECK(statistics.GetCount() == 3);
+    CHECK(statistics.GetMin() == 100us);
+    CHECK(statistics.GetMax() == 300us);
+    CHECK(statistics.GetMean() == 200us);
+  }
+
+  SECTION("should estimate percentiles within a bucket")
+  {
+    for (int i = 1; i <= 100; i++)
+    {
+      statistics.Record(std::chrono::microseconds(i * 10));
+    }
+    // Buckets are at most 25% wide
+    CHECK(statistics.GetPercentile(50) >= 500us);
+    CHECK(statistics.GetPercentile(50) <= 625us);
+    CHECK(statistics.GetPercentile(99) >= 990us);
+    CHECK(statistics.GetPercentile(99) <= 1000us);
+    CHECK(statistics.GetPercentile(100) == 1000us);
+  }
+
+  SECTION("should clamp negative durations to zero")
+  {
+    statistics.Record(-5us);
+    CHECK(statistics.GetMax() == 0us);
+  }
+
+  SECTION("should forget samples on reset")
+  {
+    statistics.Record(100us);
+    statistics.Reset();
+    CHECK(statistics.GetCount() == 0);
+    CHECK(statistics.GetMax() == 0us);
+  }
+}
+
+TEST_CASE("Testing PeriodicExecutive")
+{
+  fake_time = 0ns;
+  common::PeriodicExecutive<2> executive(10ms, FakeUptime, FakeDelay);
+  std::chrono::nanoseconds step_time = 2ms;
+  int runs                           = 0;
+  executive.AddStep(
+      "step",
+      [&]() {
+        runs++;
+        fake_time += step_time;
+      },
+      3ms);
+
+  SECTION("should start cycles at absolute deadlines without drift")
+  {
+    for (int i = 0; i < 5; i++)
+    {
+      executive.RunCycle();
+    }
+    CHECK(runs == 5);
+    CHECK(fake_time == 50ms);
+    CHECK(executive.GetOverruns() == 0);
+    CHECK(executive.GetStartJitter().GetMax() == 0us);
+    CHECK(executive.GetStep(0).execution_time.GetMean() == 2ms);
+    CHECK(executive.GetStep(0).overruns == 0);
+  }
+
+  SECTION("should flag steps over their budget")
+  {
+    step_time = 4ms;
+    executive.RunCycle();
+    CHECK(executive.GetStep(0).overruns == 1);
+    CHECK(executive.GetOverruns() == 0);
+  }
+
+  SECTION("should skip missed deadlines instead of catching up")
+  {
+    executive.RunCycle();
+    step_time = 25ms;
+    executive.RunCycle();
+    // Cycle started at 10ms and ended at 35ms, missing the 20ms and 30ms
+    // deadlines, so the next cycle starts at 40ms
+    CHECK(executive.GetOverruns() == 1);
+    CHECK(executive.GetMissedCycles() == 2);
+    CHECK(fake_time == 40ms);
+
+    step_time = 2ms;
+    executive.RunCycle();
+    CHECK(fake_time == 50ms);
+    CHECK(executive.GetCycleTime().GetMax() == 25ms);
+  }
+
+  SECTION("should measure how late cycles start")
+  {
+    executive.RunCycle();
+    fake_time += 1ms;
+    executive.RunCycle();
+    CHECK(executive.GetStartJitter().GetMax() == 1ms);
+  }
+
+  SECTION("should refuse steps beyond its capacity")
+  {
+    CHECK(executive.AddStep("second", []() {}));
+    CHECK(!executive.AddStep("third", []() {}));
+    CHECK(executive.GetStepCount() == 2);
+  }
+
+  SECTION("should defer its report to the deferred log")
+  {
+    decltype(common::deferred_log)::Entry entry;
+    while (common::deferred_log.Pop(entry))
+    {
+    }
+    executive.RunCycle();
+    executive.DeferStatistics();
+
+    // Summary, cycle, jitter and one line per step
+    std::array<char, 128> line;
+    int lines = 0;
+    while (common::deferred_log.Pop(entry))
+    {
+      lines++;
+      common::deferred_log.Format(entry, line);
+    }
+    CHECK(lines == 4);
+    CHECK(std::string_view(line.data()) ==
+          "step         p50  2000us p99  2000us max  2000us overruns 0");
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,50 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/request_writer.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing Request Writer")
+{
+  common::StaticRequestWriter<32> writer;
+
+  SECTION("should append text, characters and integers")
+  {
+    writer.Append("GET /").Append('d').AppendInteger(-42).AppendInteger(7);
+    CHECK(writer.GetView() == "GET /d-427");
+    CHECK(!writer.HasOverflowed());
+  }
+
+  SECTION("should write fixed precision numbers")
+  {
+    writer.AppendFixed(12.345f).Append(' ');
+    writer.AppendFixed(-0.5f).Append(' ');
+    writer.AppendFixed(-0.001f).Append(' ');
+    writer.AppendFixed(3.0f, 0).Append(' ');
+    writer.AppendFixed(100.05f, 1);
+    CHECK(writer.GetView() == "12.35 -0.50 0.00 3 100.1");
+  }
+
+  SECTION("should separate query parameters")
+  {
+    writer.Append("drive")
+        .AppendParameter("a", 1)
+        .AppendParameter("b", 'S')
+        .AppendParameter("c", 2.5);
+    CHECK(writer.GetView() == "drive?a=1&b=S&c=2.50");
+  }
+
+  SECTION("should flag writes that do not fit without overrunning")
+  {
+    writer.Append("0123456789012345678901234567890");
+    CHECK(!writer.HasOverflowed());
+    writer.Append("too long");
+    CHECK(writer.HasOverflowed());
+    CHECK(writer.GetLength() == 31);
+
+    writer.Clear();
+    CHECK(!writer.HasOverflowed());
+    CHECK(writer.GetView().empty());
+  }
+}
+}  // namespace sjsu
@@ -0,0 +1,231 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/esp.hpp"
+#include "../../Common/ring_uart.hpp"
+
+namespace sjsu
+{
+namespace
+{
+/// Hardware UART whose receive FIFO holds whatever the test puts in it
+class FakeHardwareUart : public Uart
+{
+ public:
+  void ModuleInitialize() override
+  {
+    initialized_baud_rate = settings.baud_rate;
+  }
+
+  void Write(std::span<const uint8_t> data) override
+  {
+    written.insert(written.end(), data.begin(), data.end());
+  }
+
+  size_t Read(std::span<uint8_t> data) override
+  {
+    size_t count = std::min(data.size(), fifo.size());
+    std::copy_n(fifo.begin(), count, data.begin());
+    fifo.erase(fifo.begin(), fifo.begin() + count);
+    return count;
+  }
+
+  size_t HasData() override
+  {
+    return fifo.size();
+  }
+
+  std::vector<uint8_t> fifo;
+  std::vector<uint8_t> written;
+  uint32_t initialized_baud_rate = 0;
+};
+
+int interrupt_enables = 0;
+void EnableInterrupt()
+{
+  interrupt_enables++;
+}
+
+int idle_waits = 0;
+void CountingDelay(std::chrono::nanoseconds)
+{
+  idle_waits++;
+}
+
+void SleepingDelay(std::chrono::nanoseconds duration)
+{
+  idle_waits++;
+  std::this_thread::sleep_for(duration);
+}
+
+uint8_t PatternByte(size_t index)
+{
+  return static_cast<uint8_t>((index * 31) % 251);
+}
+}  // namespace
+
+TEST_CASE("Testing Byte Ring")
+{
+  common::ByteRing<8> ring;
+  std::array<uint8_t, 8> out;
+
+  SECTION("should keep the order of bytes across the wrap around")
+  {
+    for (uint8_t start = 0; start < 40; start += 5)
+    {
+      std::array<uint8_t, 5> in = { start,
+                                    uint8_t(start + 1),
+                                    uint8_t(start + 2),
+                                    uint8_t(start + 3),
+                                    uint8_t(start + 4) };
+      CHECK(ring.Push(in) == 5);
+      CHECK(ring.Size() == 5);
+      CHECK(ring.Pop(out) == 5);
+      for (uint8_t i = 0; i < 5; i++)
+      {
+        CHECK(out[i] == start + i);
+      }
+      CHECK(ring.IsEmpty());
+    }
+    CHECK(ring.GetDroppedCount() == 0);
+    CHECK(ring.GetPeakSize() == 5);
+  }
+
+  SECTION("should drop and count the bytes that do not fit")
+  {
+    std::array<uint8_t, 6> in = { 1, 2, 3, 4, 5, 6 };
+    CHECK(ring.Push(in) == 6);
+    CHECK(ring.Push(in) == 2);
+    CHECK(ring.GetDroppedCount() == 4);
+    CHECK(ring.GetPeakSize() == 8);
+
+    // The queued bytes were kept, not overwritten
+    CHECK(ring.Pop(out) == 8);
+    CHECK(out == std::array<uint8_t, 8>{ 1, 2, 3, 4, 5, 6, 1, 2 });
+  }
+
+  SECTION("should only pop what was queued")
+  {
+    std::array<uint8_t, 3> in = { 7, 8, 9 };
+    ring.Push(in);
+    CHECK(ring.Pop(std::span(out).first(2)) == 2);
+    CHECK(ring.Pop(out) == 1);
+    CHECK(out[0] == 9);
+    CHECK(ring.Pop(out) == 0);
+  }
+}
+
+TEST_CASE("Testing Ring UART")
+{
+  interrupt_enables = 0;
+  idle_waits        = 0;
+  FakeHardwareUart hardware;
+
+  SECTION("should initialize the hardware then enable its interrupt")
+  {
+    common::RingUart<64> uart(hardware, EnableInterrupt);
+    uart.settings.baud_rate = 115200;
+    uart.Initialize();
+    CHECK(hardware.initialized_baud_rate == 115200);
+    CHECK(interrupt_enables == 1);
+  }
+
+  SECTION("should write straight to the hardware")
+  {
+    common::RingUart<64> uart(hardware);
+    std::array<uint8_t, 3> command = { 'A', 'T', '\r' };
+    uart.Write(command);
+    CHECK(hardware.written == std::vector<uint8_t>{ 'A', 'T', '\r' });
+  }
+
+  SECTION("should drain the whole hardware FIFO on each interrupt")
+  {
+    common::RingUart<64> uart(hardware);
+    for (size_t i = 0; i < 40; i++)
+    {
+      hardware.fifo.push_back(PatternByte(i));
+    }
+    uart.OnReceiveInterrupt();
+    CHECK(hardware.fifo.empty());
+    CHECK(uart.HasData() == 40);
+
+    std::array<uint8_t, 64> data;
+    CHECK(uart.Read(data) == 40);
+    for (size_t i = 0; i < 40; i++)
+    {
+      CHECK(data[i] == PatternByte(i));
+    }
+  }
+
+  SECTION("should only idle while the ring is empty")
+  {
+    common::RingUart<64> uart(hardware, nullptr, 1ms, CountingDelay);
+    CHECK(uart.HasData() == 0);
+    CHECK(idle_waits == 1);
+    std::array<uint8_t, 1> byte = { 'K' };
+    uart.Receive(byte);
+    CHECK(uart.HasData() == 1);
+    CHECK(idle_waits == 1);
+  }
+
+  SECTION("should not lose bytes at line rate while the reader is busy")
+  {
+    // Same capacity as the ring the rover receives esp responses into
+    using EspUart = common::RingUart<common::Esp::kReceiveRingCapacity>;
+    // 921600 baud, 10 bits per byte, delivered a FIFO's worth at a time
+    constexpr size_t kBytesPerSecond = 92160;
+    constexpr size_t kTotalBytes     = 32 * 1024;
+    constexpr std::chrono::nanoseconds kChunkPeriod =
+        std::chrono::nanoseconds(1s) * EspUart::kFifoSize /
+        kBytesPerSecond;
+    // 5ms of other work between reads piles up ~460 bytes
+    constexpr std::chrono::nanoseconds kBusyTime = 5ms;
+
+    EspUart uart(hardware, nullptr, 100us, SleepingDelay);
+    std::atomic<bool> is_done = false;
+    std::thread producer([&] {
+      std::array<uint8_t, EspUart::kFifoSize> chunk;
+      auto next = std::chrono::steady_clock::now();
+      for (size_t sent = 0; sent < kTotalBytes; sent += chunk.size())
+      {
+        for (size_t i = 0; i < chunk.size(); i++)
+        {
+          chunk[i] = PatternByte(sent + i);
+        }
+        next += kChunkPeriod;
+        std::this_thread::sleep_until(next);
+        uart.Receive(chunk);
+      }
+      is_done = true;
+    });
+
+    size_t received   = 0;
+    size_t mismatches = 0;
+    std::array<uint8_t, 256> data;
+    while (received < kTotalBytes && !(is_done && !uart.HasData()))
+    {
+      while (uart.HasData())
+      {
+        size_t count = uart.Read(data);
+        for (size_t i = 0; i < count; i++)
+        {
+          mismatches += (data[i] != PatternByte(received + i));
+        }
+        received += count;
+      }
+      std::this_thread::sleep_for(kBusyTime);
+    }
+    producer.join();
+
+    CHECK(received == kTotalBytes);
+    CHECK(mismatches == 0);
+    CHECK(uart.GetRing().GetDroppedCount() == 0);
+    CHECK(uart.GetRing().GetPeakSize() < common::Esp::kReceiveRingCapacity);
+  }
+}
+}  // namespace sjsu
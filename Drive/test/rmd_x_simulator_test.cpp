@@ -0,0 +1,183 @@
+#include "testing/testing_frameworks.hpp"
+#include "peripherals/lpc40xx/can.hpp"
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/math/units.hpp"
+
+#include "../../Common/rmd_x_simulator.hpp"
+#include "motor_feedback.hpp"
+#include "motor_group.hpp"
+#include "rover_drive_system.hpp"
+#include "wheel.hpp"
+
+namespace sjsu
+{
+namespace
+{
+Can::Message_t Request(uint32_t id, uint8_t command)
+{
+  Can::Message_t message;
+  message.id         = id;
+  message.length     = 8;
+  message.payload[0] = command;
+  return message;
+}
+}  // namespace
+
+TEST_CASE("Testing RmdXSimulator")
+{
+  Mock<Can> mock_can;
+  Fake(Method(mock_can, Can::ModuleInitialize));
+
+  common::RmdXSimulator<6> simulator(
+      { 0x141, 0x142, 0x143, 0x144, 0x145, 0x146 });
+  When(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &)))
+      .AlwaysDo([&](const Can::Message_t & m) { simulator.Send(m); });
+  When(Method(mock_can, Can::HasData)).AlwaysDo([&]() {
+    return simulator.HasData();
+  });
+  When(Method(mock_can, Can::Receive)).AlwaysDo([&]() {
+    return simulator.Receive();
+  });
+
+  StaticMemoryResource<1024> memory_resource;
+  CanNetwork network(mock_can.get(), &memory_resource);
+
+  sjsu::RmdX left_steer_motor(network, 0x141);
+  sjsu::RmdX left_hub_motor(network, 0x142);
+  sjsu::RmdX right_steer_motor(network, 0x143);
+  sjsu::RmdX right_hub_motor(network, 0x144);
+  sjsu::RmdX back_steer_motor(network, 0x145);
+  sjsu::RmdX back_hub_motor(network, 0x146);
+
+  left_steer_motor.settings.gear_ratio  = 8;
+  left_hub_motor.settings.gear_ratio    = 8;
+  right_steer_motor.settings.gear_ratio = 8;
+  right_hub_motor.settings.gear_ratio   = 8;
+  back_steer_motor.settings.gear_ratio  = 8;
+  back_hub_motor.settings.gear_ratio    = 8;
+
+  drive::MotorFeedbackCache<6> feedback(network, { { { 0x141, 8 },
+                                                     { 0x142, 8 },
+                                                     { 0x143, 8 },
+                                                     { 0x144, 8 },
+                                                     { 0x145, 8 },
+                                                     { 0x146, 8 } } });
+
+  SECTION("should accelerate to a speed within the acceleration limit")
+  {
+    // 10rpm * 6 * 8 = 480dps at the motor
+    left_hub_motor.SetSpeed(10_rpm);
+    simulator.Run(5ms);
+    auto * motor = simulator.GetMotor(0x142);
+    CHECK(motor->speed == doctest::Approx(180.0));
+    CHECK(motor->acceleration == doctest::Approx(36000.0));
+
+    simulator.Run(100ms);
+    CHECK(motor->speed == doctest::Approx(480.0));
+    CHECK(motor->acceleration == doctest::Approx(0.0));
+  }
+
+  SECTION("should answer speed commands and status requests")
+  {
+    left_hub_motor.SetSpeed(10_rpm);
+    simulator.Run(100ms);
+    mock_can.get().Send(Request(0x142, 0x9C));
+
+    while (simulator.HasData())
+    {
+      feedback.Decode(simulator.Receive());
+    }
+    CHECK(feedback.GetFeedback(0x142)->speed.to<double>() ==
+          doctest::Approx(10.0));
+    CHECK(feedback.GetFeedback(0x142)->temperature.to<double>() ==
+          doctest::Approx(30.0));
+    // Friction only while turning at a steady speed
+    CHECK(feedback.GetFeedback(0x142)->current.to<double>() ==
+          doctest::Approx(0.5).epsilon(0.05));
+  }
+
+  SECTION("should stop at the commanded angle without overshooting")
+  {
+    left_steer_motor.SetAngle(90_deg, 20_rpm);
+    auto * motor   = simulator.GetMotor(0x141);
+    float furthest = 0.0f;
+    for (int i = 0; i < 1000; i++)
+    {
+      simulator.Step(1ms);
+      furthest = std::max(furthest, motor->angle);
+    }
+    CHECK(furthest <= 720.0f);
+    CHECK(motor->angle == doctest::Approx(720.0));
+    CHECK(motor->speed == doctest::Approx(0.0));
+
+    mock_can.get().Send(Request(0x141, 0x92));
+    while (simulator.HasData())
+    {
+      feedback.Decode(simulator.Receive());
+    }
+    CHECK(feedback.GetFeedback(0x141)->angle.to<double>() ==
+          doctest::Approx(90.0));
+  }
+
+  SECTION("should act on multi-motor frames with every motor")
+  {
+    drive::MotorGroup<3> hub_motors(
+        network, { &left_hub_motor, &right_hub_motor, &back_hub_motor });
+    hub_motors.settings.use_broadcast = true;
+    hub_motors.SetSpeed(10_rpm);
+    simulator.Run(100ms);
+    CHECK(simulator.GetMotor(0x142)->speed == doctest::Approx(480.0));
+    CHECK(simulator.GetMotor(0x144)->speed == doctest::Approx(480.0));
+    CHECK(simulator.GetMotor(0x146)->speed == doctest::Approx(480.0));
+    // Multi-motor frames reach the steer motors too
+    CHECK(simulator.GetMotor(0x141)->speed == doctest::Approx(480.0));
+  }
+
+  SECTION("should switch the rover into drive mode and drive off")
+  {
+    drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+    drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
+    drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+    left_wheel.SetFeedback(feedback.GetFeedback(0x142),
+                           feedback.GetFeedback(0x141));
+    right_wheel.SetFeedback(feedback.GetFeedback(0x144),
+                            feedback.GetFeedback(0x143));
+    back_wheel.SetFeedback(feedback.GetFeedback(0x146),
+                           feedback.GetFeedback(0x145));
+    drive::RoverDriveSystem drive_system(left_wheel, right_wheel, back_wheel);
+    drive_system.SetSpeedRamp({}, 10ms);
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 20, "angle": 0})");
+
+    // Same order as ActuationTask, one 10ms control period per tick
+    auto tick = [&]() {
+      feedback.Update();
+      drive_system.HandleRoverMovement();
+      drive_system.UpdateWheelSpeeds();
+      simulator.Run(10ms);
+    };
+
+    int ticks = 0;
+    while (drive_system.GetCurrentMode() != 'D' && ticks < 500)
+    {
+      tick();
+      ticks++;
+    }
+    // The back wheel turns 90 degrees at 20rpm (120 degrees per second)
+    CHECK(drive_system.GetCurrentMode() == 'D');
+    CHECK(ticks >= 75);
+    CHECK(ticks <= 150);
+    CHECK(back_wheel.GetMeasuredPosition() ==
+          doctest::Approx(90.0).epsilon(0.03));
+
+    for (int i = 0; i < 200; i++)
+    {
+      tick();
+    }
+    CHECK(left_wheel.GetMeasuredSpeed() == doctest::Approx(20.0));
+    CHECK(right_wheel.GetMeasuredSpeed() == doctest::Approx(20.0));
+    CHECK(back_wheel.GetMeasuredSpeed() == doctest::Approx(20.0));
+    CHECK(simulator.GetDroppedReplies() == 0);
+  }
+}
+}  // namespace sjsu
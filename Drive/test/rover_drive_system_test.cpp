@@ -4,11 +4,30 @@
 #include "utility/log.hpp"
 #include "utility/math/units.hpp"
 
+#include "motor_feedback.hpp"
 #include "rover_drive_system.hpp"
 #include "wheel.hpp"
 
 namespace sjsu
 {
+namespace
+{
+/// Multi-turn angle reply from an 8:1 RMD-X at the given output angle
+Can::Message_t AngleReply(uint32_t id, double degrees)
+{
+  auto angle = static_cast<int64_t>(degrees * 8 * 100);
+  Can::Message_t message;
+  message.id         = id;
+  message.length     = 8;
+  message.payload[0] = 0x92;
+  for (size_t i = 1; i < 8; i++)
+  {
+    message.payload[i] = static_cast<uint8_t>(angle >> (8 * (i - 1)));
+  }
+  return message;
+}
+}  // namespace
+
 TEST_CASE("Testing Drive System")
 {
   Mock<Can> mock_can;
@@ -49,13 +68,16 @@ TEST_CASE("Testing Drive System")
 
   SECTION("should correctly create GET request with current data")
   {
-    std::string expectedParam =
-        "drive?is_operational=1&drive_mode=S&battery=90&left_wheel_speed=0."
-        "000000&left_wheel_angle=0.000000&right_wheel_speed=0.000000&right_"
-        "wheel_angle=0.000000&back_wheel_speed=0.000000&back_wheel_angle=0."
-        "000000";
-    std::string reqParam = drive_system.CreateRequestParameters();
-    CHECK(reqParam == expectedParam);
+    std::string_view expected_param =
+        "Vishnu-Adda/json-robo-test/"
+        "drive?is_operational=1&drive_mode=S&battery=90&left_wheel_speed=0.00&"
+        "left_wheel_angle=0.00&right_wheel_speed=0.00&right_wheel_angle=0.00&"
+        "back_wheel_speed=0.00&back_wheel_angle=0.00";
+    common::StaticRequestWriter<300> writer;
+    drive_system.mc_data.is_operational = 1;
+    drive_system.CreateRequestParameters(writer);
+    CHECK(!writer.HasOverflowed());
+    CHECK(writer.GetView() == expected_param);
   }
 
   SECTION("should parse mission control response")
@@ -69,6 +91,78 @@ TEST_CASE("Testing Drive System")
     CHECK(drive_system.mc_data.rotation_angle == doctest::Approx(10.0));
   }
 
+  SECTION("should parse reordered responses with unknown fields")
+  {
+    std::string_view response = R"({
+      "angle":-22.5, "extra": {"nested": [1, 2]},
+      "speed" : 1e1, "drive_mode":"T", "is_operational":true
+    })";
+    uint8_t fields = drive_system.ParseJSONResponse(response);
+    CHECK(fields == drive::kAllFields);
+    CHECK(drive_system.mc_data.is_operational == 1);
+    CHECK(drive_system.mc_data.drive_mode == 'T');
+    CHECK(drive_system.mc_data.speed == doctest::Approx(10.0));
+    CHECK(drive_system.mc_data.rotation_angle == doctest::Approx(-22.5));
+  }
+
+  SECTION("should only update the fields present in the response")
+  {
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 10.0, "angle": 5})");
+    uint8_t fields = drive_system.ParseJSONResponse(R"({"speed": -3.25})");
+    CHECK(fields == drive::kSpeedField);
+    CHECK(drive_system.mc_data.drive_mode == 'D');
+    CHECK(drive_system.mc_data.speed == doctest::Approx(-3.25));
+    CHECK(drive_system.mc_data.rotation_angle == doctest::Approx(5.0));
+  }
+
+  SECTION("should exchange binary frames")
+  {
+    std::array<uint8_t, drive::protocol::kTelemetryFrameSize> telemetry;
+    CHECK(drive_system.CreateTelemetryFrame(telemetry) == telemetry.size());
+    CHECK(drive_system.CreateTelemetryFrame(std::span(telemetry).first(4)) ==
+          0);
+
+    drive::MissionControlData command = { 1, 'D', 10.0f, 15.0f };
+    std::array<uint8_t, drive::protocol::kCommandFrameSize> frame;
+    drive::protocol::EncodeCommandFrame(command, 5, frame);
+    CHECK(drive_system.ParseCommandFrame(frame));
+    CHECK(drive_system.mc_data.drive_mode == 'D');
+    CHECK(drive_system.mc_data.speed == doctest::Approx(15.0));
+    CHECK(drive_system.mc_data.rotation_angle == doctest::Approx(10.0));
+
+    // Replayed or out of order frames are ignored
+    command.speed = 50.0f;
+    drive::protocol::EncodeCommandFrame(command, 4, frame);
+    CHECK(!drive_system.ParseCommandFrame(frame));
+    CHECK(drive_system.mc_data.speed == doctest::Approx(15.0));
+  }
+
+  SECTION("should resync with a restarted mission control")
+  {
+    drive::MissionControlData command = { 1, 'D', 0.0f, 15.0f };
+    std::array<uint8_t, drive::protocol::kCommandFrameSize> frame;
+    drive::protocol::EncodeCommandFrame(command, 30000, frame);
+    CHECK(drive_system.ParseCommandFrame(frame));
+
+    // Far behind the last command, so it numbers from 0 again
+    command.speed = 20.0f;
+    drive::protocol::EncodeCommandFrame(command, 0, frame);
+    CHECK(drive_system.ParseCommandFrame(frame));
+    CHECK(drive_system.mc_data.speed == doctest::Approx(20.0));
+
+    // A restart soon after boot is only a few frames behind, it resyncs once
+    // the old sequence has gone quiet
+    drive::protocol::EncodeCommandFrame(command, 10, frame);
+    CHECK(drive_system.ParseCommandFrame(frame));
+    command.speed = 25.0f;
+    drive::protocol::EncodeCommandFrame(command, 1, frame);
+    CHECK(!drive_system.ParseCommandFrame(frame));
+    sjsu::Delay(2s);
+    CHECK(drive_system.ParseCommandFrame(frame));
+    CHECK(drive_system.mc_data.speed == doctest::Approx(25.0));
+  }
+
   SECTION("should stop rover & reset wheel positions")
   {
     drive_system.HomeWheels();
@@ -80,6 +174,20 @@ TEST_CASE("Testing Drive System")
     CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(0.0));
   }
 
+  SECTION("should home all wheels at the same time")
+  {
+    drive_system.StartHomingWheels();
+    // Every wheel reads its mark on the first step
+    CHECK(drive_system.GetHomingStatus() == drive::HomingStatus::kHomed);
+    CHECK(drive_system.left_wheel_.GetHomingStatus() ==
+          drive::HomingStatus::kHomed);
+    CHECK(drive_system.right_wheel_.GetHomingStatus() ==
+          drive::HomingStatus::kHomed);
+    CHECK(drive_system.back_wheel_.GetHomingStatus() ==
+          drive::HomingStatus::kHomed);
+    CHECK(drive_system.HomeWheels() == drive::HomingStatus::kHomed);
+  }
+
   SECTION("should set wheel speeds to 10_rpm")
   {
     drive_system.SetWheelSpeed(10_rpm);
@@ -88,6 +196,64 @@ TEST_CASE("Testing Drive System")
     CHECK(drive_system.back_wheel_.GetSpeed() == doctest::Approx(10.0));
   }
 
+  SECTION("should ramp wheel speeds once a speed ramp is set")
+  {
+    drive_system.SetSpeedRamp({ .acceleration = 200.0f, .jerk = 1000.0f },
+                              10ms);
+    drive_system.SetWheelSpeed(10_rpm);
+    CHECK(drive_system.left_wheel_.GetSpeed() == doctest::Approx(0.0));
+    CHECK(drive_system.AreWheelsStopped());
+
+    drive_system.UpdateWheelSpeeds();
+    CHECK(!drive_system.AreWheelsStopped());
+    CHECK(drive_system.left_wheel_.GetSpeed() > 0.0);
+    CHECK(drive_system.left_wheel_.GetSpeed() < 10.0);
+
+    for (int i = 0; i < 100; i++)
+    {
+      drive_system.UpdateWheelSpeeds();
+    }
+    CHECK(drive_system.left_wheel_.GetSpeed() == doctest::Approx(10.0));
+    CHECK(drive_system.right_wheel_.GetSpeed() == doctest::Approx(10.0));
+    CHECK(drive_system.back_wheel_.GetSpeed() == doctest::Approx(10.0));
+  }
+
+  SECTION("should ramp a wheel through zero when its hub flips")
+  {
+    drive_system.SetSpeedRamp({ .acceleration = 200.0f, .jerk = 1000.0f },
+                              10ms);
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 10.0, "angle": 0})");
+    for (int tick = 0; tick < 200; tick++)
+    {
+      drive_system.HandleRoverMovement();
+      drive_system.UpdateWheelSpeeds();
+    }
+    CHECK(drive_system.GetCurrentMode() == 'D');
+    CHECK(!drive_system.back_wheel_.IsHubInverted());
+    CHECK(drive_system.back_wheel_.GetSpeed() == doctest::Approx(10.0));
+
+    // Closer to 185 degrees with the hub inverted than by turning 95 degrees
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 10.0, "angle": 95})");
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.back_wheel_.IsHubInverted());
+    // The hub motor still turns the same way, rolling the wheel backwards
+    CHECK(drive_system.back_wheel_.GetSpeed() == doctest::Approx(-10.0));
+
+    drive_system.UpdateWheelSpeeds();
+    CHECK(drive_system.back_wheel_.GetSpeed() > -10.0);
+    CHECK(drive_system.back_wheel_.GetSpeed() < 0.0);
+
+    for (int tick = 0; tick < 200; tick++)
+    {
+      drive_system.HandleRoverMovement();
+      drive_system.UpdateWheelSpeeds();
+    }
+    CHECK(drive_system.back_wheel_.GetSpeed() == doctest::Approx(10.0));
+    CHECK(drive_system.left_wheel_.GetSpeed() == doctest::Approx(10.0));
+  }
+
   SECTION("should stop rover and set current_mode_ to drive")
   {
     CHECK(drive_system.GetCurrentMode() == 'S');
@@ -104,10 +270,94 @@ TEST_CASE("Testing Drive System")
     CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(90.0));
   }
 
+  SECTION("should only switch modes once the wheels reach their angles")
+  {
+    drive::MotorFeedbackCache<6> feedback(network, { { { 0x141, 8 },
+                                                       { 0x142, 8 },
+                                                       { 0x143, 8 },
+                                                       { 0x144, 8 },
+                                                       { 0x145, 8 },
+                                                       { 0x146, 8 } } });
+    left_wheel.SetFeedback(feedback.GetFeedback(0x142),
+                           feedback.GetFeedback(0x141));
+    right_wheel.SetFeedback(feedback.GetFeedback(0x144),
+                            feedback.GetFeedback(0x143));
+    back_wheel.SetFeedback(feedback.GetFeedback(0x146),
+                           feedback.GetFeedback(0x145));
+    feedback.Decode(AngleReply(0x141, 0));
+    feedback.Decode(AngleReply(0x143, 0));
+    feedback.Decode(AngleReply(0x145, 0));
+
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 15.0, "angle": 0})");
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.GetCurrentMode() == 'S');
+
+    // Only some of the wheels have arrived. The right wheel turns to 45
+    // degrees with its hub inverted instead of turning to -135 degrees.
+    feedback.Decode(AngleReply(0x141, -45));
+    feedback.Decode(AngleReply(0x143, 44));
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.GetCurrentMode() == 'S');
+
+    feedback.Decode(AngleReply(0x145, 89));
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.GetCurrentMode() == 'D');
+    CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(90.0));
+    CHECK(drive_system.right_wheel_.GetMeasuredPosition() ==
+          doctest::Approx(-136.0));
+    CHECK(drive_system.back_wheel_.GetMeasuredPosition() ==
+          doctest::Approx(89.0));
+  }
+
+  SECTION("should steer back when a mode switch is called off")
+  {
+    drive::MotorFeedbackCache<6> feedback(network, { { { 0x141, 8 },
+                                                       { 0x142, 8 },
+                                                       { 0x143, 8 },
+                                                       { 0x144, 8 },
+                                                       { 0x145, 8 },
+                                                       { 0x146, 8 } } });
+    left_wheel.SetFeedback(feedback.GetFeedback(0x142),
+                           feedback.GetFeedback(0x141));
+    right_wheel.SetFeedback(feedback.GetFeedback(0x144),
+                            feedback.GetFeedback(0x143));
+    back_wheel.SetFeedback(feedback.GetFeedback(0x146),
+                           feedback.GetFeedback(0x145));
+    // Already at the drive mode angles, the right wheel with its hub inverted
+    feedback.Decode(AngleReply(0x141, -45));
+    feedback.Decode(AngleReply(0x143, 45));
+    feedback.Decode(AngleReply(0x145, 90));
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 0, "angle": 0})");
+    drive_system.HandleRoverMovement();
+    REQUIRE(drive_system.GetCurrentMode() == 'D');
+
+    // Spin mode is called off before the wheels get there
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "S", "speed": 0, "angle": 0})");
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.left_wheel_.GetPosition() == doctest::Approx(0.0));
+    using drive::FlightRecord;
+    CHECK(drive_system.GetFlightRecord().flags & FlightRecord::kSwitching);
+
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 20, "angle": 0})");
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.left_wheel_.GetPosition() == doctest::Approx(-45.0));
+    CHECK(drive_system.right_wheel_.GetPosition() == doctest::Approx(-135.0));
+    CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(90.0));
+    CHECK(drive_system.GetCurrentMode() == 'D');
+    CHECK(!(drive_system.GetFlightRecord().flags & FlightRecord::kSwitching));
+  }
+
   SECTION("should adjust rover speed to 15.0 and rotation angle to 20.0")
   {
-    CHECK(drive_system.GetCurrentMode() != 'D');  // TODO: why isn't it drive?
+    // Each SECTION starts from a fresh drive system, so switch to drive first
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 15.0, "angle": 20.0})");
     drive_system.HandleRoverMovement();
+    CHECK(drive_system.GetCurrentMode() == 'D');
     drive_system.HandleRoverMovement();
     CHECK(drive_system.GetCurrentMode() == drive_system.mc_data.drive_mode);
     CHECK(drive_system.left_wheel_.GetSpeed() == doctest::Approx(15.0));
@@ -117,5 +367,75 @@ TEST_CASE("Testing Drive System")
     CHECK(drive_system.right_wheel_.GetPosition() == doctest::Approx(-135.0));
     CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(110.0));
   }
+
+  SECTION("should hold the steering angle while a command repeats")
+  {
+    // The actuation task handles the latest command every control cycle
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "D", "speed": 10.0, "angle": 15})");
+    for (int tick = 0; tick < 100; tick++)
+    {
+      drive_system.HandleRoverMovement();
+    }
+    CHECK(drive_system.GetCurrentMode() == 'D');
+    CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(105.0));
+    CHECK(drive_system.left_wheel_.GetPosition() == doctest::Approx(-45.0));
+
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "T", "speed": 10.0, "angle": 10})");
+    for (int tick = 0; tick < 100; tick++)
+    {
+      drive_system.HandleRoverMovement();
+    }
+    CHECK(drive_system.GetCurrentMode() == 'T');
+    CHECK(drive_system.left_wheel_.GetPosition() == doctest::Approx(55.0));
+    CHECK(drive_system.right_wheel_.GetPosition() == doctest::Approx(-35.0));
+    CHECK(drive_system.back_wheel_.GetPosition() == doctest::Approx(-170.0));
+  }
+
+  SECTION("should report an unknown drive mode instead of moving")
+  {
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "X", "speed": 15.0, "angle": 0})");
+    CHECK(drive_system.HandleRoverMovement() ==
+          common::Status::kInvalidMode);
+    CHECK(drive_system.GetCurrentMode() == 'S');
+    CHECK(drive_system.left_wheel_.GetSpeed() == doctest::Approx(0.0));
+  }
+
+  SECTION("should log a refused mode once instead of every cycle")
+  {
+    decltype(common::deferred_log)::Entry entry;
+    while (common::deferred_log.Pop(entry))
+    {
+    }
+    auto count_errors = [&entry]() {
+      int errors = 0;
+      while (common::deferred_log.Pop(entry))
+      {
+        errors += (entry.level == common::LogLevel::kError);
+      }
+      return errors;
+    };
+
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "X", "speed": 15.0, "angle": 0})");
+    for (int i = 0; i < 10; i++)
+    {
+      CHECK(drive_system.HandleRoverMovement() ==
+            common::Status::kInvalidMode);
+    }
+    CHECK(count_errors() == 1);
+
+    // No geometry was measured, so velocity mode is refused as well
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "V", "speed": 15.0, "angle": 0})");
+    for (int i = 0; i < 10; i++)
+    {
+      CHECK(drive_system.HandleRoverMovement() ==
+            common::Status::kInvalidMode);
+    }
+    CHECK(count_errors() == 1);
+  }
 }
 }  // namespace sjsu
\ No newline at end of file
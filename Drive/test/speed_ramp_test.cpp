@@ -0,0 +1,69 @@
+#include <cmath>
+
+#include "testing/testing_frameworks.hpp"
+#include "utility/math/units.hpp"
+
+#include "speed_ramp.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing SpeedRamp")
+{
+  constexpr std::chrono::nanoseconds kPeriod = 10ms;
+  constexpr float kDt                        = 0.01f;
+  drive::SpeedRamp ramp({ .acceleration = 200.0f, .jerk = 1000.0f });
+
+  SECTION("should reach the target without exceeding its limits")
+  {
+    float previous_speed        = 0;
+    float previous_acceleration = 0;
+    int steps                   = 0;
+    while (ramp.GetSpeed() != 100_rpm && steps < 1000)
+    {
+      float speed = ramp.Update(100_rpm, kPeriod).to<float>();
+      CHECK(speed <= 100.0f);
+      CHECK(speed >= previous_speed);
+      CHECK(ramp.GetAcceleration() <= 200.0f + 1e-3f);
+      CHECK(std::fabs(ramp.GetAcceleration() - previous_acceleration) <=
+            1000.0f * kDt + 1e-3f);
+      previous_speed        = speed;
+      previous_acceleration = ramp.GetAcceleration();
+      steps++;
+    }
+    // Fastest profile: 0.2s to build up acceleration, 0.3s at the limit and
+    // 0.2s to ease off is 0.7s
+    CHECK(steps >= 65);
+    CHECK(steps <= 72);
+
+    ramp.Update(100_rpm, kPeriod);
+    CHECK(ramp.GetSpeed() == 100_rpm);
+    CHECK(ramp.GetAcceleration() == doctest::Approx(0.0));
+  }
+
+  SECTION("should take small steps without reaching the acceleration limit")
+  {
+    for (int i = 0; i < 100; i++)
+    {
+      ramp.Update(5_rpm, kPeriod);
+      CHECK(ramp.GetSpeed() <= 5_rpm);
+    }
+    CHECK(ramp.GetSpeed() == 5_rpm);
+  }
+
+  SECTION("should ramp down and reverse smoothly")
+  {
+    ramp.Reset(50_rpm);
+    for (int i = 0; i < 300; i++)
+    {
+      ramp.Update(-50_rpm, kPeriod);
+      CHECK(ramp.GetSpeed() >= -50_rpm);
+    }
+    CHECK(ramp.GetSpeed() == -50_rpm);
+  }
+
+  SECTION("should not move without time passing")
+  {
+    CHECK(ramp.Update(100_rpm, 0ns) == 0_rpm);
+  }
+}
+}  // namespace sjsu
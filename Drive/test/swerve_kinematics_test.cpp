@@ -0,0 +1,137 @@
+#include "testing/testing_frameworks.hpp"
+#include "peripherals/lpc40xx/can.hpp"
+#include "devices/actuators/servo/rmd_x.hpp"
+#include "utility/math/units.hpp"
+
+#include "rover_drive_system.hpp"
+#include "swerve_kinematics.hpp"
+#include "wheel.hpp"
+
+namespace sjsu
+{
+TEST_CASE("Testing SwerveKinematics")
+{
+  using Kinematics = drive::RoverDriveSystem::Kinematics;
+  constexpr Kinematics kinematics(drive::RoverDriveSystem::kGeometry);
+
+  SECTION("should match the drive mode angles when driving forward")
+  {
+    Kinematics::Commands commands = kinematics.Solve({ 0.5f, 0, 0 }, 100_rpm);
+    CHECK(commands[0].angle.to<double>() == doctest::Approx(-45.0));
+    CHECK(commands[1].angle.to<double>() == doctest::Approx(-135.0));
+    CHECK(commands[2].angle.to<double>() == doctest::Approx(90.0));
+    for (const drive::WheelCommand & command : commands)
+    {
+      CHECK(command.speed.to<double>() ==
+            doctest::Approx(kinematics.ToWheelSpeed(0.5f).to<double>()));
+    }
+  }
+
+  SECTION("should match the spin mode angles when turning clockwise")
+  {
+    Kinematics::Commands commands = kinematics.Solve({ 0, 0, -1.0f }, 100_rpm);
+    for (const drive::WheelCommand & command : commands)
+    {
+      CHECK(command.angle.to<double>() == doctest::Approx(0.0));
+      CHECK(command.speed.to<double>() ==
+            doctest::Approx(
+                kinematics.ToWheelSpeed(drive::RoverDriveSystem::kLegLength)
+                    .to<double>()));
+    }
+  }
+
+  SECTION("should match the translation mode angles when moving right")
+  {
+    Kinematics::Commands commands = kinematics.Solve({ 0, -0.5f, 0 }, 100_rpm);
+    CHECK(commands[0].angle.to<double>() == doctest::Approx(45.0));
+    CHECK(commands[1].angle.to<double>() == doctest::Approx(-45.0));
+    CHECK(commands[2].angle.to<double>() == doctest::Approx(180.0));
+  }
+
+  SECTION("should turn the outer wheel faster while driving along an arc")
+  {
+    // Forward while turning left
+    Kinematics::Commands commands =
+        kinematics.Solve({ 0.5f, 0, 0.5f }, 100_rpm);
+    CHECK(commands[1].speed > commands[0].speed);
+    // The back wheel swings right to push the tail out
+    CHECK(commands[2].angle.to<double>() > 90.0);
+  }
+
+  SECTION("should slow every wheel by the same factor to stay in limits")
+  {
+    Kinematics::Commands fast = kinematics.Solve({ 5.0f, 0, 5.0f }, 1000_rpm);
+    Kinematics::Commands limited =
+        kinematics.Solve({ 5.0f, 0, 5.0f }, 100_rpm);
+
+    units::angular_velocity::revolutions_per_minute_t fastest = 0_rpm;
+    for (const drive::WheelCommand & command : limited)
+    {
+      fastest = std::max(fastest, command.speed);
+    }
+    CHECK(fastest.to<double>() == doctest::Approx(100.0));
+    for (size_t i = 0; i < limited.size(); i++)
+    {
+      CHECK(limited[i].angle.to<double>() ==
+            doctest::Approx(fast[i].angle.to<double>()));
+      CHECK((limited[i].speed / fast[i].speed) ==
+            doctest::Approx(limited[0].speed / fast[0].speed));
+    }
+  }
+
+  SECTION("should leave stopped wheels where they are")
+  {
+    Kinematics::Commands commands = kinematics.Solve({}, 100_rpm);
+    for (const drive::WheelCommand & command : commands)
+    {
+      CHECK(Kinematics::IsStopped(command));
+    }
+  }
+
+  SECTION("should drive and turn without stopping in velocity mode")
+  {
+    Mock<Can> mock_can;
+    Fake(Method(mock_can, Can::ModuleInitialize));
+    Fake(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &)));
+    Fake(Method(mock_can, Can::Receive));
+    Fake(Method(mock_can, Can::HasData));
+
+    StaticMemoryResource<1024> memory_resource;
+    CanNetwork network(mock_can.get(), &memory_resource);
+
+    sjsu::RmdX left_steer_motor(network, 0x141);
+    sjsu::RmdX left_hub_motor(network, 0x142);
+    sjsu::RmdX right_steer_motor(network, 0x143);
+    sjsu::RmdX right_hub_motor(network, 0x144);
+    sjsu::RmdX back_steer_motor(network, 0x145);
+    sjsu::RmdX back_hub_motor(network, 0x146);
+    drive::Wheel left_wheel(left_hub_motor, left_steer_motor);
+    drive::Wheel right_wheel(right_hub_motor, right_steer_motor);
+    drive::Wheel back_wheel(back_hub_motor, back_steer_motor);
+    drive::RoverDriveSystem drive_system(left_wheel, right_wheel, back_wheel);
+
+    // Not without knowing how far the wheels are from the center
+    drive_system.ParseJSONResponse(
+        R"({"is_operational": 1, "drive_mode": "V", "speed": 20, "angle": 0})");
+    CHECK(drive_system.HandleRoverMovement() ==
+          common::Status::kInvalidMode);
+    CHECK(drive_system.GetCurrentMode() == 'S');
+
+    drive_system.SetGeometry(drive::RoverDriveSystem::kGeometry);
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.GetCurrentMode() == 'V');
+    drive_system.HandleRoverMovement();
+    CHECK(left_wheel.GetPosition() == doctest::Approx(-45.0));
+    CHECK(back_wheel.GetPosition() == doctest::Approx(90.0));
+    CHECK(left_wheel.GetSpeed() == doctest::Approx(20.0));
+
+    // Turning right on the next tick, the wheels keep rolling
+    drive_system.mc_data.rotation_angle = 30.0f;
+    drive_system.HandleRoverMovement();
+    CHECK(drive_system.GetCurrentMode() == 'V');
+    CHECK(left_wheel.GetSpeed() > right_wheel.GetSpeed());
+    CHECK(right_wheel.GetSpeed() > 0.0);
+    CHECK(back_wheel.GetPosition() < 90.0);
+  }
+}
+}  // namespace sjsu
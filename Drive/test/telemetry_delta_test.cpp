@@ -0,0 +1,149 @@
+#include <array>
+#include <string_view>
+
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/request_writer.hpp"
+#include "../telemetry_delta.hpp"
+
+namespace sjsu
+{
+namespace
+{
+drive::protocol::DriveTelemetry Driving(float speed, float angle)
+{
+  drive::protocol::DriveTelemetry telemetry;
+  telemetry.is_operational = 1;
+  telemetry.drive_mode     = 'D';
+  telemetry.battery        = 87;
+  telemetry.left           = { speed, -45.0f + angle };
+  telemetry.right          = { speed, -135.0f + angle };
+  telemetry.back           = { speed, 90.0f + angle };
+  return telemetry;
+}
+
+/// Writes every field like RoverDriveSystem::WriteRequestParameters()
+/// @return number of bytes written
+size_t WriteAllFields(common::RequestWriter & writer,
+                      const drive::protocol::DriveTelemetry & telemetry)
+{
+  // A keyframe without the keyframe parameter
+  drive::TelemetryDeltaEncoder encoder;
+  encoder.Write(writer, telemetry);
+  return writer.GetLength() - std::string_view("?keyframe=1").size();
+}
+}  // namespace
+
+TEST_CASE("Testing Telemetry Delta Encoding")
+{
+  common::StaticRequestWriter<512> writer;
+  drive::TelemetryDeltaEncoder encoder;
+  drive::TelemetryDeltaDecoder decoder;
+
+  auto send = [&](const drive::protocol::DriveTelemetry & telemetry,
+                  bool is_acknowledged = true) {
+    writer.Clear();
+    writer.Append("drive");
+    uint16_t fields = encoder.Write(writer, telemetry);
+    if (is_acknowledged)
+    {
+      decoder.Apply(writer.GetView());
+      encoder.Acknowledge();
+    }
+    return fields;
+  };
+
+  SECTION("should start with a keyframe of every field")
+  {
+    CHECK(send(Driving(20.0f, 0.0f)) == drive::kAllTelemetry);
+    CHECK(writer.GetView() ==
+          "drive?keyframe=1&is_operational=1&drive_mode=D&battery=87"
+          "&left_wheel_speed=20.00&left_wheel_angle=-45.00"
+          "&right_wheel_speed=20.00&right_wheel_angle=-135.00"
+          "&back_wheel_speed=20.00&back_wheel_angle=90.00");
+    CHECK(decoder.HasKeyframe());
+    CHECK(decoder.GetTelemetry().drive_mode == 'D');
+    CHECK(decoder.GetTelemetry().right.angle == doctest::Approx(-135.0));
+  }
+
+  SECTION("should send nothing while nothing changed")
+  {
+    send(Driving(20.0f, 0.0f));
+    CHECK(send(Driving(20.0f, 0.0f)) == 0);
+    CHECK(writer.GetView() == "drive");
+  }
+
+  SECTION("should only send changes larger than the deadband")
+  {
+    send(Driving(20.0f, 0.0f));
+    CHECK(send(Driving(20.4f, 0.4f)) == 0);
+
+    drive::protocol::DriveTelemetry telemetry = Driving(20.0f, 0.0f);
+    telemetry.left.speed = 21.0f;
+    telemetry.back.angle = 80.0f;
+    telemetry.drive_mode = 'S';
+    CHECK(send(telemetry) == (drive::kDriveModeTelemetry |
+                              drive::kLeftSpeedTelemetry |
+                              drive::kBackAngleTelemetry));
+    CHECK(writer.GetView() ==
+          "drive?drive_mode=S&left_wheel_speed=21.00&back_wheel_angle=80.00");
+    CHECK(decoder.GetTelemetry().left.speed == doctest::Approx(21.0));
+    CHECK(decoder.GetTelemetry().back.angle == doctest::Approx(80.0));
+    CHECK(decoder.GetTelemetry().right.speed == doctest::Approx(20.0));
+  }
+
+  SECTION("should measure drift from the last acknowledged value")
+  {
+    send(Driving(20.0f, 0.0f));
+    CHECK(send(Driving(20.3f, 0.0f)) == 0);
+    CHECK(send(Driving(20.6f, 0.0f)) ==
+          (drive::kLeftSpeedTelemetry | drive::kRightSpeedTelemetry |
+           drive::kBackSpeedTelemetry));
+  }
+
+  SECTION("should send changes again until they are acknowledged")
+  {
+    send(Driving(20.0f, 0.0f));
+    uint16_t lost = send(Driving(25.0f, 0.0f), false);
+    CHECK(lost != 0);
+    CHECK(send(Driving(25.0f, 0.0f)) == lost);
+    CHECK(decoder.GetTelemetry().back.speed == doctest::Approx(25.0));
+    CHECK(send(Driving(25.0f, 0.0f)) == 0);
+  }
+
+  SECTION("should send a keyframe every keyframe interval")
+  {
+    constexpr uint32_t kInterval =
+        drive::TelemetryDeltaEncoder::kDefaultKeyframeInterval;
+    send(Driving(20.0f, 0.0f));
+    for (uint32_t i = 0; i < kInterval; i++)
+    {
+      CHECK(send(Driving(20.0f, 0.0f)) == 0);
+    }
+    CHECK(send(Driving(20.0f, 0.0f)) == drive::kAllTelemetry);
+    CHECK(writer.GetView().starts_with("drive?keyframe=1&"));
+  }
+
+  SECTION("should cut telemetry bytes several-fold while driving steadily")
+  {
+    common::StaticRequestWriter<512> full;
+    size_t full_bytes  = 0;
+    size_t delta_bytes = 0;
+    // Measured speeds and angles jitter around the commanded ones
+    constexpr std::array<float, 5> kNoise = { 0.0f, 0.2f, -0.3f, 0.1f, -0.2f };
+    for (int tick = 0; tick < 500; tick++)
+    {
+      float noise = kNoise[tick % kNoise.size()];
+      drive::protocol::DriveTelemetry telemetry = Driving(20.0f + noise, noise);
+
+      send(telemetry);
+      CHECK(decoder.GetTelemetry().left.speed ==
+            doctest::Approx(20.0).epsilon(0.03));
+      delta_bytes += writer.GetLength() - std::string_view("drive").size();
+      full.Clear();
+      full_bytes += WriteAllFields(full, telemetry);
+    }
+    CHECK(full_bytes > 4 * delta_bytes);
+  }
+}
+}  // namespace sjsu
@@ -58,12 +58,45 @@ TEST_CASE("Testing Wheel")
 
   SECTION("should set extreme wheel positions")
   {
+    // Positions wrap to (-180, 180]
     wheel.SetSteeringAngle(500_deg);
-    CHECK(wheel.GetPosition() == doctest::Approx(360.0));
+    CHECK(wheel.GetPosition() == doctest::Approx(140.0));
 
-    wheel.SetSteeringAngle(-360_deg);  // resets wheel to zero
+    wheel.SetSteeringAngle(-360_deg);  // a full turn is no turn
+    CHECK(wheel.GetPosition() == doctest::Approx(140.0));
     wheel.SetSteeringAngle(-500_deg);
-    CHECK(wheel.GetPosition() == doctest::Approx(-360.0));
+    CHECK(wheel.GetPosition() == doctest::Approx(0.0));
+    CHECK(wheel.homing_offset_angle_ == 0_deg);
+  }
+
+  SECTION("should steer the short way around")
+  {
+    wheel.SetSteeringPosition(170_deg);
+    wheel.SetSteeringPosition(-170_deg);
+    CHECK(wheel.GetPosition() == doctest::Approx(-170.0));
+    // Through 180 rather than back through 0
+    CHECK(wheel.homing_offset_angle_.to<double>() == doctest::Approx(10.0));
+  }
+
+  SECTION("should invert the hub instead of turning more than 90 degrees")
+  {
+    wheel.SetHubSpeed(10_rpm);
+    wheel.SetSteeringPosition(135_deg);
+    CHECK(wheel.GetPosition() == doctest::Approx(135.0));
+    CHECK(wheel.IsHubInverted());
+    // Until the next speed is sent the hub motor turns the wheel backwards
+    CHECK(wheel.GetSpeed() == doctest::Approx(-10.0));
+    CHECK(wheel.homing_offset_angle_.to<double>() == doctest::Approx(-45.0));
+    CHECK(wheel.ToHubMotorSpeed(10_rpm) == -10_rpm);
+
+    // Back within 90 degrees of the steer motor, no need to stay inverted
+    wheel.SetSteeringPosition(0_deg);
+    CHECK(!wheel.IsHubInverted());
+    CHECK(wheel.homing_offset_angle_.to<double>() == doctest::Approx(0.0));
+
+    wheel.SetSteeringPosition(180_deg);
+    CHECK(wheel.IsHubInverted());
+    CHECK(wheel.homing_offset_angle_.to<double>() == doctest::Approx(0.0));
   }
 
   SECTION("should home wheel positions")
@@ -72,4 +105,55 @@ TEST_CASE("Testing Wheel")
     CHECK(wheel.homing_offset_angle_ == 0_deg);
   }
 }
+
+TEST_CASE("Testing Wheel homing")
+{
+  Mock<Can> mock_can;
+  Fake(Method(mock_can, Can::ModuleInitialize));
+  Fake(OverloadedMethod(mock_can, Can::Send, void(const Can::Message_t &)));
+  Fake(Method(mock_can, Can::Receive));
+  Fake(Method(mock_can, Can::HasData));
+
+  Mock<Gpio> mock_homing_pin;
+  Fake(Method(mock_homing_pin, Gpio::ModuleInitialize));
+  Fake(Method(mock_homing_pin, Gpio::SetDirection));
+  When(Method(mock_homing_pin, Gpio::Read)).AlwaysReturn(Gpio::kHigh);
+
+  StaticMemoryResource<1024> memory_resource;
+  CanNetwork network(mock_can.get(), &memory_resource);
+
+  sjsu::RmdX rmd_wheel_left(network, 0x140);
+  sjsu::RmdX rmd_steer_left(network, 0x141);
+
+  sjsu::drive::Wheel wheel(rmd_wheel_left, rmd_steer_left,
+                           mock_homing_pin.get());
+
+  SECTION("should finish immediately when already home")
+  {
+    When(Method(mock_homing_pin, Gpio::Read)).AlwaysReturn(Gpio::kLow);
+    wheel.StartHoming();
+    CHECK(wheel.GetHomingStatus() == drive::HomingStatus::kHomed);
+  }
+
+  SECTION("should home once the slip ring mark is reached")
+  {
+    wheel.SetSteeringAngle(30_deg);
+    wheel.StartHoming();
+    CHECK(wheel.UpdateHoming() == drive::HomingStatus::kHoming);
+    CHECK(wheel.UpdateHoming() == drive::HomingStatus::kHoming);
+
+    When(Method(mock_homing_pin, Gpio::Read)).AlwaysReturn(Gpio::kLow);
+    CHECK(wheel.UpdateHoming() == drive::HomingStatus::kHomed);
+    CHECK(wheel.GetPosition() == doctest::Approx(0.0));
+  }
+
+  SECTION("should fail when the mark is not found in time")
+  {
+    wheel.StartHoming(0ns);
+    CHECK(wheel.UpdateHoming() == drive::HomingStatus::kFailed);
+    // Stays failed until homing is started again
+    When(Method(mock_homing_pin, Gpio::Read)).AlwaysReturn(Gpio::kLow);
+    CHECK(wheel.UpdateHoming() == drive::HomingStatus::kFailed);
+  }
+}
 }  // namespace sjsu
@@ -0,0 +1,129 @@
+#include "testing/testing_frameworks.hpp"
+
+#include "../../Common/wifi_link.hpp"
+
+namespace sjsu
+{
+namespace
+{
+std::chrono::nanoseconds fake_time = 0ns;
+std::chrono::nanoseconds FakeUptime()
+{
+  return fake_time;
+}
+
+/// Access point that accepts associations only while it is in range. Each
+/// association takes association_time.
+class FakeWiFi : public WiFi
+{
+ public:
+  bool ConnectToAccessPoint(std::string_view,
+                            std::string_view,
+                            std::chrono::nanoseconds) override
+  {
+    attempts++;
+    fake_time += association_time;
+    is_connected = is_in_range;
+    return is_connected;
+  }
+
+  void DisconnectFromAccessPoint() override
+  {
+    is_connected = false;
+  }
+
+  bool IsConnected() override
+  {
+    checks++;
+    return is_connected && is_in_range;
+  }
+
+  bool is_in_range                          = true;
+  bool is_connected                         = false;
+  int attempts                              = 0;
+  int checks                                = 0;
+  std::chrono::nanoseconds association_time = 100ms;
+};
+}  // namespace
+
+TEST_CASE("Testing WiFi Link")
+{
+  fake_time = 0ns;
+  FakeWiFi wifi;
+  common::WiFiLink link(wifi, "ssid", "password", FakeUptime);
+
+  SECTION("should associate on the first update")
+  {
+    CHECK(!link.IsUp());
+    CHECK(link.Update());
+    CHECK(wifi.attempts == 1);
+    CHECK(link.GetStatistics().last_recovery_time == 100ms);
+  }
+
+  SECTION("should back off exponentially up to the maximum")
+  {
+    wifi.is_in_range = false;
+    std::chrono::nanoseconds expected_backoff = common::WiFiLink::kFirstBackoff;
+    for (int attempt = 1; attempt <= 10; attempt++)
+    {
+      CHECK(!link.Update());
+      CHECK(wifi.attempts == attempt);
+      // Nothing happens until the backoff after the attempt's start is over
+      fake_time += expected_backoff - wifi.association_time - 1ms;
+      CHECK(!link.Update());
+      CHECK(wifi.attempts == attempt);
+      fake_time += 1ms;
+      expected_backoff =
+          std::min(expected_backoff * 2, common::WiFiLink::kMaxBackoff);
+    }
+    CHECK(link.GetBackoff() == common::WiFiLink::kMaxBackoff);
+  }
+
+  SECTION("should only check the link once per check period")
+  {
+    CHECK(link.Update());
+    int checks = wifi.checks;
+    for (int tick = 0; tick < 99; tick++)
+    {
+      fake_time += 10ms;
+      CHECK(link.Update());
+    }
+    CHECK(wifi.checks == checks);
+    fake_time += 10ms;
+    CHECK(link.Update());
+    CHECK(wifi.checks == checks + 1);
+  }
+
+  SECTION("should check the link right after a reported failure")
+  {
+    CHECK(link.Update());
+    wifi.is_in_range = false;
+    link.ReportFailure();
+    CHECK(!link.Update());
+    CHECK(link.GetStatistics().dropouts == 1);
+  }
+
+  SECTION("should measure how long it took to recover from a dropout")
+  {
+    CHECK(link.Update());
+    fake_time += 5s;
+    wifi.is_in_range = false;
+    CHECK(!link.Update());
+    std::chrono::nanoseconds lost_at = fake_time;
+
+    // Two failed attempts, 250ms and 500ms of backoff
+    CHECK(!link.Update());
+    fake_time += 250ms;
+    CHECK(!link.Update());
+    fake_time += 500ms;
+    wifi.is_in_range = true;
+    CHECK(link.Update());
+
+    CHECK(wifi.attempts == 4);
+    CHECK(link.GetStatistics().dropouts == 1);
+    CHECK(link.GetStatistics().last_recovery_time == fake_time - lost_at);
+    CHECK(link.GetStatistics().longest_recovery_time == 1050ms);
+    CHECK(link.GetBackoff() == common::WiFiLink::kFirstBackoff);
+  }
+}
+}  // namespace sjsu
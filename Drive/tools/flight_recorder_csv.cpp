@@ -0,0 +1,85 @@
+// Converts flight recorder dumps in a captured serial console log to CSV,
+// one row per control cycle. Every dump in the log is converted, separated
+// by a blank line. Lines around the dumps (regular log output) are skipped.
+//
+// Build & run: make -C Drive/tools
+//              build/flight_recorder_csv console.log > flight.csv
+
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "../flight_record.hpp"
+
+namespace
+{
+using sjsu::drive::DriveFlightRecorder;
+using sjsu::drive::FlightRecord;
+
+/// @return the part of the line after marker, nullptr if marker is missing
+const char * Find(const char * line, const char * marker)
+{
+  const char * found = strstr(line, marker);
+  return (found == nullptr) ? nullptr : found + strlen(marker);
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  FILE * input = (argc > 1) ? fopen(argv[1], "r") : stdin;
+  if (input == nullptr)
+  {
+    fprintf(stderr, "Unable to open %s\n", argv[1]);
+    return 1;
+  }
+
+  char line[512];
+  bool is_in_dump = false;
+  int dumps       = 0;
+  int records     = 0;
+  int bad_lines   = 0;
+  while (fgets(line, sizeof(line), input) != nullptr)
+  {
+    if (const char * header = Find(line, DriveFlightRecorder::kBeginMarker))
+    {
+      size_t record_size = 0;
+      if (sscanf(header, "%zu", &record_size) != 1 ||
+          record_size != sizeof(FlightRecord))
+      {
+        fprintf(stderr,
+                "Skipping dump of %zu byte records, expected %zu. Built "
+                "from a different firmware version?\n",
+                record_size, sizeof(FlightRecord));
+        continue;
+      }
+      if (dumps > 0)
+      {
+        printf("\n");
+      }
+      sjsu::drive::WriteFlightRecordCsvHeader(stdout);
+      is_in_dump = true;
+      dumps++;
+    }
+    else if (is_in_dump && Find(line, DriveFlightRecorder::kEndMarker))
+    {
+      is_in_dump = false;
+    }
+    else if (is_in_dump)
+    {
+      FlightRecord record;
+      if (DriveFlightRecorder::ParseDumpLine(line, record))
+      {
+        sjsu::drive::WriteFlightRecordCsv(stdout, record);
+        records++;
+      }
+      else
+      {
+        bad_lines++;
+      }
+    }
+  }
+
+  fprintf(stderr, "%d records from %d dumps, %d unreadable lines\n", records,
+          dumps, bad_lines);
+  return (dumps == 0) ? 1 : 0;
+}
@@ -1,16 +1,39 @@
 #pragma once
 
+#include <chrono>
+#include <cmath>
+
 #include "devices/actuators/servo/rmd_x.hpp"
 #include "peripherals/lpc40xx/gpio.hpp"
+#include "utility/time/time.hpp"
+
+#include "motor_feedback.hpp"
 
 namespace sjsu::drive
 {
+/// Progress of a wheel (or all wheels) returning to the slip ring mark
+enum class HomingStatus : uint8_t
+{
+  kIdle,
+  kHoming,
+  kHomed,
+  kFailed,
+};
+
 /// Wheel class manages steering & hub motors for the rover.
 class Wheel
 {
  public:
-  Wheel(sjsu::RmdX & hub_motor, sjsu::RmdX & steer_motor)
-      : hub_motor_(hub_motor), steer_motor_(steer_motor){};
+  /// A full turn at kHomingSpeed takes 3s, so the mark is always found
+  /// within this time unless something is wrong
+  static constexpr std::chrono::nanoseconds kHomingTimeout = 5s;
+
+  Wheel(sjsu::RmdX & hub_motor,
+        sjsu::RmdX & steer_motor,
+        sjsu::Gpio & homing_pin = sjsu::lpc40xx::GetGpio<1, 30>())
+      : hub_motor_(hub_motor),
+        steer_motor_(steer_motor),
+        homing_pin_(homing_pin){};
 
   void Initialize()
   {
@@ -21,93 +44,274 @@ class Wheel
   };
 
   /// Gets the speed of the hub motor.
-  double GetSpeed()
+  float GetSpeed()
   {
-    return hub_speed_.to<double>();
+    return hub_speed_.to<float>();
   };
 
-  /// Gets the angle/position of the steering motor.
-  double GetPosition()
+  /// Gets the angle/position of the wheel relative to home, normalized to
+  /// (-180, 180]. The steer motor may point the opposite way with the hub
+  /// running in reverse, see IsHubInverted().
+  float GetPosition()
   {
-    return homing_offset_angle_.to<double>();
+    return steering_angle_.to<float>();
   };
 
-  /// Sets the speed of the hub motor. Will not surpass max/min value
-  /// @param hub_speed the new speed of the wheel
-  void SetHubSpeed(units::angular_velocity::revolutions_per_minute_t hub_speed)
+  /// @return true if the steer motor points opposite to GetPosition() and the
+  ///         hub motor runs in reverse to make up for it
+  bool IsHubInverted() const
+  {
+    return hub_inverted_;
+  }
+
+  /// Attaches measured motor state, usually from a MotorFeedbackCache
+  /// @param hub_feedback latest state of the hub motor
+  /// @param steer_feedback latest state of the steer motor
+  void SetFeedback(const MotorFeedback * hub_feedback,
+                   const MotorFeedback * steer_feedback)
+  {
+    hub_feedback_   = hub_feedback;
+    steer_feedback_ = steer_feedback;
+  }
+
+  /// Gets the measured speed of the hub motor, or the commanded speed if no
+  /// feedback has been received.
+  float GetMeasuredSpeed()
   {
-    try
+    if (hub_feedback_ == nullptr || !hub_feedback_->HasStatus())
     {
-      sjsu::LogInfo("made it to sethubspeed()");
-      // units::angular_velocity::revolutions_per_minute_t num = hub_speed / 10;
-      hub_motor_.SetSpeed(hub_speed);
-      auto clampedHubSpeed = std::clamp(hub_speed, kMaxNegSpeed, kMaxPosSpeed);
-      // for (int i = 0; i < 10; i++)
-      // {
-      //   hub_motor_.SetSpeed(num);
-      //   num += num;
-      //   sjsu::Delay(200ms);
-      // }
+      return GetSpeed();
     }
-    catch (const std::exception & e)
+    return ToHubMotorSpeed(hub_feedback_->speed).to<float>();
+  }
+
+  /// Gets the measured angle of the wheel like GetPosition(), or the
+  /// commanded angle if no feedback has been received.
+  float GetMeasuredPosition()
+  {
+    if (steer_feedback_ == nullptr || !steer_feedback_->HasAngle())
+    {
+      return GetPosition();
+    }
+    units::angle::degree_t steer_angle = steer_feedback_->angle - home_angle_;
+    if (hub_inverted_)
     {
-      sjsu::LogInfo("made it to sethubspeed() - something broke!");
-      throw e;
+      steer_angle += 180_deg;
     }
+    return NormalizeAngle(steer_angle).to<float>();
+  }
 
-    /*
-    auto clampedHubSpeed = std::clamp(hub_speed, kMaxNegSpeed, kMaxPosSpeed);
-    hub_motor_.SetSpeed(clampedHubSpeed);
-    hub_speed_ = clampedHubSpeed;
-    */
+  /// Sets the speed of the hub motor. Will not surpass max/min value
+  /// @param hub_speed the new speed of the wheel
+  void SetHubSpeed(units::angular_velocity::revolutions_per_minute_t hub_speed)
+  {
+    // Clamp before sending so the motor never sees an out of range speed
+    auto clamped_hub_speed = LimitHubSpeed(hub_speed);
+    hub_motor_.SetSpeed(ToHubMotorSpeed(clamped_hub_speed));
+    hub_speed_ = clamped_hub_speed;
+  }
+
+  /// Limits a hub speed to the wheel's max/min without sending it.
+  /// @param hub_speed the requested speed of the wheel
+  units::angular_velocity::revolutions_per_minute_t LimitHubSpeed(
+      units::angular_velocity::revolutions_per_minute_t hub_speed) const
+  {
+    return std::clamp(hub_speed, kMaxNegSpeed, kMaxPosSpeed);
+  }
+
+  /// @return fastest hub speed the wheel allows in either direction
+  units::angular_velocity::revolutions_per_minute_t GetMaxSpeed() const
+  {
+    return kMaxPosSpeed;
+  }
+
+  /// Converts between wheel speed and hub motor speed, which are opposite
+  /// while the hub is inverted.
+  /// @param hub_speed speed of the wheel (or of the hub motor)
+  units::angular_velocity::revolutions_per_minute_t ToHubMotorSpeed(
+      units::angular_velocity::revolutions_per_minute_t hub_speed) const
+  {
+    return hub_inverted_ ? -hub_speed : hub_speed;
+  }
+
+  /// Records a hub speed that was sent to the hub motor by a MotorGroup
+  /// instead of SetHubSpeed().
+  /// @param hub_speed wheel speed before ToHubMotorSpeed()
+  void UpdateHubSpeed(
+      units::angular_velocity::revolutions_per_minute_t hub_speed)
+  {
+    hub_speed_ = hub_speed;
   }
 
   /// Adjusts the steer motor by the provided rotation angle/degree.
   /// @param rotation_angle positive angle (turn right), negative angle (left)
   void SetSteeringAngle(units::angle::degree_t rotation_angle)
   {
-    auto clampedRotationAngle =
-        std::clamp(rotation_angle, kMaxNegRotation, kMaxPosRotation);
-    units::angle::degree_t difference_angle =
-        (homing_offset_angle_ + clampedRotationAngle);
-
-    steer_motor_.SetAngle(difference_angle, kSteeringSpeed);
-    homing_offset_angle_ += clampedRotationAngle;
+    SetSteeringPosition(steering_angle_ + rotation_angle);
   };
 
-  // Sets the wheel back in its homing position by finding mark in slip ring
-  void HomeWheel()
+  /// Turns the wheel to an angle relative to home along the shortest path.
+  /// Rather than turning more than 90 degrees, the steer motor turns to the
+  /// opposite angle and the hub motor runs in reverse. Nothing is sent to the
+  /// hub motor when it is inverted, so the wheel rolls the other way until
+  /// the owner sends the next speed, i.e. RoverDriveSystem ramps it through
+  /// zero.
+  /// @param position positive angle (right of home), negative angle (left)
+  void SetSteeringPosition(units::angle::degree_t position)
   {
-    sjsu::LogInfo("homing...");
-    bool home_level = sjsu::Gpio::kLow;
-    if (homing_pin_.Read() == home_level)
+    units::angle::degree_t target = NormalizeAngle(position);
+    // Turn to the target, or to its opposite with the hub inverted
+    units::angle::degree_t heading  = NormalizeAngle(homing_offset_angle_);
+    units::angle::degree_t rotation = NormalizeAngle(target - heading);
+    bool invert                     = units::math::abs(rotation) > 90_deg;
+    if (invert)
+    {
+      rotation = NormalizeAngle(rotation - 180_deg);
+    }
+
+    // The steer motor's own zero is wherever it powered on
+    homing_offset_angle_ += rotation;
+    steer_motor_.SetAngle(home_angle_ + homing_offset_angle_, kSteeringSpeed);
+    steering_angle_ = target;
+
+    if (invert != hub_inverted_)
+    {
+      hub_inverted_ = invert;
+      // The hub motor keeps turning the same way, which now rolls the wheel
+      // the opposite way
+      hub_speed_ = -hub_speed_;
+    }
+  }
+
+  /// @param tolerance largest acceptable steering error
+  /// @return true if the measured steer motor angle is within tolerance of
+  ///         the commanded angle. Always true without motor feedback, never
+  ///         true while attached feedback has yet to measure an angle.
+  bool IsSteeringSettled(units::angle::degree_t tolerance)
+  {
+    if (steer_feedback_ == nullptr)
+    {
+      return true;
+    }
+    if (!steer_feedback_->HasAngle())
+    {
+      return false;
+    }
+    units::angle::degree_t error =
+        steer_feedback_->angle - home_angle_ - homing_offset_angle_;
+    return units::math::abs(error) <= tolerance;
+  }
+
+  /// @return angle wrapped to (-180, 180]
+  static units::angle::degree_t NormalizeAngle(units::angle::degree_t angle)
+  {
+    float degrees = std::remainder(angle.to<float>(), 360.0f);
+    return units::angle::degree_t((degrees <= -180.0f) ? degrees + 360.0f
+                                                       : degrees);
+  }
+
+  /// Starts turning the steer motor towards the slip ring mark without
+  /// waiting for it. Step the homing with UpdateHoming() until it is no longer
+  /// HomingStatus::kHoming.
+  /// @param timeout homing fails if the mark isn't found within this time
+  void StartHoming(std::chrono::nanoseconds timeout = kHomingTimeout)
+  {
+    homing_deadline_ = sjsu::Uptime() + timeout;
+    if (homing_pin_.Read() == kHomeLevel)
     {
       sjsu::LogInfo("already home");
+      FinishHoming();
       return;
     }
+    steer_motor_.SetSpeed(kHomingSpeed);
+    homing_status_ = HomingStatus::kHoming;
+  }
 
-    steer_motor_.SetSpeed(20_rpm);
-    while (homing_pin_.Read() != home_level)
+  /// Checks the slip ring once and stops the steer motor at the mark or once
+  /// the homing times out. Never blocks.
+  /// @return the homing status after this step
+  HomingStatus UpdateHoming()
+  {
+    if (homing_status_ != HomingStatus::kHoming)
+    {
+      return homing_status_;
+    }
+    if (homing_pin_.Read() == kHomeLevel)
+    {
+      steer_motor_.SetSpeed(0_rpm);
+      FinishHoming();
+    }
+    else if (sjsu::Uptime() >= homing_deadline_)
     {
-      sjsu::LogInfo("spinning");
-      break;  // for testing purposes - comment out
+      steer_motor_.SetSpeed(0_rpm);
+      homing_status_ = HomingStatus::kFailed;
+      sjsu::LogError("Wheel did not find its home mark in time!");
+    }
+    return homing_status_;
+  }
+
+  HomingStatus GetHomingStatus() const
+  {
+    return homing_status_;
+  }
+
+  /// Sets the wheel back in its homing position by finding mark in slip ring.
+  /// Blocks until the wheel is home or the homing times out.
+  void HomeWheel()
+  {
+    sjsu::LogInfo("homing...");
+    StartHoming();
+    while (UpdateHoming() == HomingStatus::kHoming)
+    {
+      sjsu::Delay(kHomingPollPeriod);
     }
-    steer_motor_.SetSpeed(0_rpm);
   };
 
+  /// Positions are relative to home from now on
+  void FinishHoming()
+  {
+    homing_offset_angle_ = 0_deg;
+    steering_angle_      = 0_deg;
+    hub_inverted_        = false;
+    homing_status_       = HomingStatus::kHomed;
+    RecordHomeAngle();
+  }
+
+  /// Measured positions are relative to the steer motor's angle at home
+  void RecordHomeAngle()
+  {
+    if (steer_feedback_ != nullptr && steer_feedback_->HasAngle())
+    {
+      home_angle_ = steer_feedback_->angle;
+    }
+  }
+
   sjsu::RmdX & hub_motor_;    /// controls tire direction (fwd/rev) & speed
   sjsu::RmdX & steer_motor_;  /// controls wheel alignment/angle
+  /// Steer motor angle from home, unwrapped
   units::angle::degree_t homing_offset_angle_                  = 0_deg;
+  /// Wheel angle from home, normalized
+  units::angle::degree_t steering_angle_                       = 0_deg;
+  bool hub_inverted_                                           = false;
   units::angular_velocity::revolutions_per_minute_t hub_speed_ = 0_rpm;
+  units::angle::degree_t home_angle_                           = 0_deg;
+  const MotorFeedback * hub_feedback_                          = nullptr;
+  const MotorFeedback * steer_feedback_                        = nullptr;
 
-  const units::angle::degree_t kMaxPosRotation = 360_deg;
-  const units::angle::degree_t kMaxNegRotation = -360_deg;
   const units::angular_velocity::revolutions_per_minute_t kMaxPosSpeed =
       100_rpm;
   const units::angular_velocity::revolutions_per_minute_t kMaxNegSpeed =
       -100_rpm;
   const units::angular_velocity::revolutions_per_minute_t kSteeringSpeed =
       20_rpm;
-  sjsu::Gpio & homing_pin_ = sjsu::lpc40xx::GetGpio<1, 30>();
+  const units::angular_velocity::revolutions_per_minute_t kHomingSpeed =
+      20_rpm;
+  static constexpr bool kHomeLevel = sjsu::Gpio::kLow;
+
+  static constexpr std::chrono::nanoseconds kHomingPollPeriod = 1ms;
+
+  sjsu::Gpio & homing_pin_;
+  HomingStatus homing_status_               = HomingStatus::kIdle;
+  std::chrono::nanoseconds homing_deadline_ = 0ns;
 };
 }  // namespace sjsu::drive